@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sched.h> // sched_setaffinity
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+#include "DeckConstants.h"
+
+// ===== Self-contained Microbenchmark Harness =====
+
+// Each kernel runs `warmup` untimed ops, then `reps` timed batches of `iters` ops.
+// Per-batch ns/op gives mean, variance and min; TSC ticks give cycles per card.
+
+struct BenchOptions {
+    uint64_t iters = 200000; // ops per timed batch
+    int reps = 15;           // timed batches
+    uint64_t warmup = 20000; // untimed ops before the first batch
+    int cpu = -1;            // pin to this CPU (-1 = don't pin)
+    std::string format = "text"; // text | json | csv
+    std::string filter;      // only run kernels whose name contains this
+};
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp = 0;    // mean over batches
+    double nsVariance = 0; // between batches
+    double nsMin = 0;
+    double cyclesPerCard = 0; // TSC (reference) cycles, 0 if unavailable
+    uint64_t iters = 0;
+    int reps = 0;
+};
+
+// Keeps a value (and the work producing it) alive without adding instructions
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline uint64_t read_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+inline bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// setup() runs before every batch (untimed), op() is the measured kernel
+template <typename Setup, typename Op>
+BenchResult run_bench(const std::string& name, const BenchOptions& opt, Setup&& setup, Op&& op) {
+    using clock = std::chrono::steady_clock;
+
+    setup();
+    for (uint64_t i = 0; i < opt.warmup; ++i) op();
+
+    std::vector<double> nsPerOp(opt.reps);
+    double tscPerOp = 0;
+
+    for (int r = 0; r < opt.reps; ++r) {
+        setup();
+
+        const auto t0 = clock::now();
+        const uint64_t c0 = read_tsc();
+        for (uint64_t i = 0; i < opt.iters; ++i) op();
+        const uint64_t c1 = read_tsc();
+        const auto t1 = clock::now();
+
+        nsPerOp[r] = std::chrono::duration<double, std::nano>(t1 - t0).count() / opt.iters;
+        tscPerOp += static_cast<double>(c1 - c0) / opt.iters;
+    }
+
+    BenchResult res;
+    res.name = name;
+    res.iters = opt.iters;
+    res.reps = opt.reps;
+
+    double sum = 0;
+    for (double v : nsPerOp) sum += v;
+    res.nsPerOp = sum / opt.reps;
+
+    double sq = 0;
+    for (double v : nsPerOp) sq += (v - res.nsPerOp) * (v - res.nsPerOp);
+    res.nsVariance = opt.reps > 1 ? sq / (opt.reps - 1) : 0;
+
+    res.nsMin = *std::min_element(nsPerOp.begin(), nsPerOp.end());
+    res.cyclesPerCard = tscPerOp / opt.reps / DECK_SIZE;
+    return res;
+}
+
+inline void print_results(const std::vector<BenchResult>& results, const BenchOptions& opt, const std::string& rev) {
+    if (opt.format == "json") {
+        std::cout << "{\n  \"benchmark\": \"kernels\",\n  \"rev\": \"" << rev << "\",\n"
+                  << "  \"cpu\": " << opt.cpu << ",\n  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            std::cout << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.nsPerOp
+                      << ", \"ns_variance\": " << r.nsVariance << ", \"ns_min\": " << r.nsMin
+                      << ", \"cycles_per_card\": " << r.cyclesPerCard
+                      << ", \"iters\": " << r.iters << ", \"reps\": " << r.reps << "}"
+                      << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ]\n}\n";
+    }
+    else if (opt.format == "csv") {
+        std::cout << "name,ns_per_op,ns_variance,ns_min,cycles_per_card,iters,reps,rev\n";
+        for (const BenchResult& r : results) {
+            std::cout << r.name << ',' << r.nsPerOp << ',' << r.nsVariance << ',' << r.nsMin << ','
+                      << r.cyclesPerCard << ',' << r.iters << ',' << r.reps << ',' << rev << '\n';
+        }
+    }
+    else {
+        std::cout << "\nShuffleLab — Kernel Benchmarks (" << rev << ")\n"
+                  << "--------------------------------\n"
+                  << std::left << std::setw(26) << "kernel"
+                  << std::right << std::setw(12) << "ns/op" << std::setw(12) << "stddev"
+                  << std::setw(12) << "min" << std::setw(14) << "cycles/card" << "\n";
+        for (const BenchResult& r : results) {
+            std::cout << std::left << std::setw(26) << r.name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << r.nsPerOp << std::setw(12) << std::sqrt(r.nsVariance)
+                      << std::setw(12) << r.nsMin << std::setw(14) << r.cyclesPerCard << "\n";
+        }
+        std::cout << "\n";
+    }
+}
@@ -0,0 +1,177 @@
+#include <cstring> // strcmp
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "Deck.h"
+#include "HandEvaluator.h"
+#include "Random.h"
+#include "Report.h"
+
+#ifndef SHUFFLELAB_GIT_REV
+#define SHUFFLELAB_GIT_REV "unknown"
+#endif
+
+// ThroughputBench.cpp
+int run_throughput_bench(int argc, char** argv, const std::string& rev);
+
+// Error Helper
+static int error(const std::string& msg) {
+    std::cerr << "error: " << msg << "\n";
+    std::cerr << "use --help for usage\n";
+    return 1;
+}
+
+static void print_usage() {
+    std::cout <<
+R"(
+USAGE:
+  shufflelab_bench [options]          Kernel microbenchmarks
+  shufflelab_bench --e2e [options]    End-to-end throughput / scaling (--e2e --help)
+
+OPTIONS:
+  --iters <int>     Ops per timed batch (default 200000)
+  --reps <int>      Timed batches per kernel (default 15)
+  --warmup <int>    Untimed ops before timing (default 20000)
+  --cpu <int>       Pin the benchmark thread to this CPU
+  --filter <str>    Only run kernels whose name contains str
+  --format <fmt>    text | json | csv (default text)
+
+)";
+}
+
+// Deck with every accumulator populated, so report_* do their full work
+static DeckContext observed_context() {
+    DeckContext ctx;
+    ctx.rng.seed(1);
+    for (int t = 0; t < 100; ++t) {
+        ctx.reset();
+        ctx.riffle();
+        ctx.riffle();
+        ctx.observe_uniformity();
+        ctx.observe_adjacency();
+        ctx.observe_displacement();
+        ctx.observe_poker(6);
+        ++ctx.numShuffles;
+    }
+    return ctx;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--e2e") == 0) return run_throughput_bench(argc, argv, SHUFFLELAB_GIT_REV);
+    }
+
+    BenchOptions opt;
+
+    for (int i = 1; i < argc; ++i) {
+        auto needValue = [&](const char* flag) { return i + 1 < argc || (error(std::string(flag) + " requires a value"), false); };
+
+        if (std::strcmp(argv[i], "--help") == 0) {
+            print_usage();
+            return 0;
+        }
+        else if (std::strcmp(argv[i], "--iters") == 0) {
+            if (!needValue("--iters")) return 1;
+            opt.iters = std::stoull(argv[++i]);
+            if (opt.iters < 1) return error("--iters must be at least 1");
+        }
+        else if (std::strcmp(argv[i], "--reps") == 0) {
+            if (!needValue("--reps")) return 1;
+            opt.reps = std::stoi(argv[++i]);
+            if (opt.reps < 1) return error("--reps must be at least 1");
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0) {
+            if (!needValue("--warmup")) return 1;
+            opt.warmup = std::stoull(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--cpu") == 0) {
+            if (!needValue("--cpu")) return 1;
+            opt.cpu = std::stoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0) {
+            if (!needValue("--filter")) return 1;
+            opt.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--format") == 0) {
+            if (!needValue("--format")) return 1;
+            opt.format = argv[++i];
+            if (opt.format != "text" && opt.format != "json" && opt.format != "csv")
+                return error("--format must be text, json or csv");
+        }
+        else {
+            return error(std::string("unknown option: ") + argv[i]);
+        }
+    }
+
+    if (opt.cpu >= 0 && !pin_to_cpu(opt.cpu)) {
+        return error("could not pin to cpu " + std::to_string(opt.cpu));
+    }
+
+    std::vector<BenchResult> results;
+    auto bench = [&](const std::string& name, auto&& setup, auto&& op) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        results.push_back(run_bench(name, opt, setup, op));
+    };
+
+    // ----- RNG -----
+    PCG32 rng;
+    rng.seed(1);
+    const auto cdf = create_cdf(5, 47, 26, 5); // cut model distribution
+
+    bench("random_bounded", []{}, [&]{ do_not_optimize(rng.random_bounded(DECK_SIZE)); });
+    bench("sample_cdf", []{}, [&]{ do_not_optimize(rng.sample_cdf(cdf)); });
+
+    // ----- Shuffles (state carries over between ops, like a long sequence) -----
+    DeckContext ctx;
+    auto fresh = [&]{ ctx.rng.seed(1); ctx.reset(); };
+
+    bench("cut", fresh, [&]{ ctx.cut(); do_not_optimize(ctx.deck); });
+    bench("riffle", fresh, [&]{ ctx.riffle(); do_not_optimize(ctx.deck); });
+    bench("hindu", fresh, [&]{ ctx.hindu(); do_not_optimize(ctx.deck); });
+    bench("overhand", fresh, [&]{ ctx.overhand(); do_not_optimize(ctx.deck); });
+    bench("random_test_shuffle", fresh, [&]{ ctx.random_test_shuffle(); do_not_optimize(ctx.deck); });
+    bench("perfect_cut", fresh, [&]{ ctx.perfect_cut(); do_not_optimize(ctx.deck); });
+    bench("perfect_riffle", fresh, [&]{ ctx.perfect_riffle(); do_not_optimize(ctx.deck); });
+
+    // ----- Observations (accumulators cleared per batch to avoid overflow) -----
+    DeckContext obs;
+    auto clearObs = [&]{
+        obs.rng.seed(1);
+        obs.reset();
+        obs.riffle();
+        obs.posFreq = {};
+        obs.adjFreq = {};
+        obs.dispHist = {};
+        obs.pokerClassFreq = {};
+        obs.pokerEquity = {};
+        obs.pokerDeals = 0;
+    };
+
+    bench("observe_uniformity", clearObs, [&]{ obs.observe_uniformity(); do_not_optimize(obs.posFreq); });
+    bench("observe_adjacency", clearObs, [&]{ obs.observe_adjacency(); do_not_optimize(obs.adjFreq); });
+    bench("observe_displacement", clearObs, [&]{ obs.observe_displacement(); do_not_optimize(obs.dispHist); });
+    bench("observe_poker_6", clearObs, [&]{ obs.observe_poker(6); do_not_optimize(obs.pokerEquity); });
+
+    // ----- Hand evaluator (a fresh random 7 cards per op) -----
+    DeckContext hands;
+    auto freshHands = [&]{ hands.rng.seed(1); hands.reset(); };
+    std::size_t handPos = 0;
+    bench("evaluate_7", freshHands, [&]{
+        if (handPos + 7 > DECK_SIZE) { hands.random_test_shuffle(); handPos = 0; }
+        do_not_optimize(evaluate_7(hands.deck.data() + handPos));
+        handPos += 7;
+    });
+
+    // ----- Reports -----
+    const DeckContext observed = observed_context();
+
+    bench("report_uniformity", []{}, [&]{ do_not_optimize(report_uniformity(observed).meanChiSq); });
+    bench("report_adjacency", []{}, [&]{ do_not_optimize(report_adjacency(observed).meanChiSq); });
+    bench("report_displacement", []{}, [&]{ do_not_optimize(report_displacement(observed).mean); });
+    bench("report_poker", []{}, [&]{ do_not_optimize(report_poker(observed, 6).chiSq); });
+
+    print_results(results, opt, SHUFFLELAB_GIT_REV);
+    return 0;
+}
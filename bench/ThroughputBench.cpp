@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring> // strcmp
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ExperimentRunner.h"
+#include "Json.h"
+#include "ThreadPool.h"
+
+// ===== End-to-end Throughput / Scaling Benchmark =====
+
+// Times ExperimentRunner::sweep() over a grid of k, trials, enabled tests and thread
+// counts, reports trials/s with speedup vs one thread, stores baselines as JSON and
+// flags regressions against a stored baseline.
+
+namespace {
+
+struct ThroughputCase {
+    int k = 0;
+    int trials = 0;
+    std::string tests; // all | uniformity | adjacency | mixing
+    int threads = 1;
+    double seconds = 0;      // median over reps
+    double trialsPerSec = 0;
+};
+
+struct ThroughputOptions {
+    std::vector<int> ks = {3, 5};
+    std::vector<int> trials = {20, 100};
+    std::vector<std::string> tests = {"all", "uniformity", "adjacency", "mixing"};
+    std::vector<int> threads; // empty = 1, 2, 4, ... up to all cores
+    int reps = 3;
+    std::string savePath;
+    std::string comparePath;
+    std::string currentPath; // compare this stored run instead of measuring
+    double threshold = 10;   // % throughput drop that counts as a regression
+    std::string format = "text";
+};
+
+int error(const std::string& msg) {
+    std::cerr << "error: " << msg << "\n";
+    std::cerr << "use --e2e --help for usage\n";
+    return 1;
+}
+
+void print_usage() {
+    std::cout <<
+R"(
+USAGE:
+  shufflelab_bench --e2e [options]
+
+SWEEP (comma-separated lists):
+  --k-list <ints>        Sequence lengths (default 3,5)
+  --trials-list <ints>   Trials per sequence (default 20,100)
+  --tests-list <names>   all, uniformity, adjacency, mixing (default all four)
+  --threads-list <ints>  Thread counts (default 1,2,4,... up to all cores)
+  --reps <int>           Timed runs per case, median kept (default 3)
+
+BASELINES:
+  --save <file>          Store results as a JSON baseline
+  --compare <file>       Flag cases slower than the baseline (exit code 2)
+  --current <file>       Compare a stored run instead of measuring
+  --threshold <pct>      Allowed throughput drop before flagging (default 10)
+  --format <fmt>         text | json (default text)
+
+)";
+}
+
+template <typename T, typename Parse>
+bool parse_list(const std::string& text, std::vector<T>& out, Parse parse) {
+    out.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) return false;
+        out.push_back(parse(item));
+    }
+    return !out.empty();
+}
+
+std::string case_key(const ThroughputCase& c) {
+    return "k=" + std::to_string(c.k) + " trials=" + std::to_string(c.trials) +
+           " tests=" + c.tests + " threads=" + std::to_string(c.threads);
+}
+
+ThroughputCase measure(int k, int trials, const std::string& tests, int threads, int reps) {
+    ExperimentRunner::ExperimentConfig cfg{};
+    cfg.kMax = k;
+    cfg.trials = trials;
+    cfg.testUniformity = tests == "all" || tests == "uniformity";
+    cfg.testAdjacency = tests == "all" || tests == "adjacency";
+    cfg.testMixing = tests == "all" || tests == "mixing";
+    cfg.seed = 1;
+    cfg.threads = threads;
+
+    std::vector<double> seconds;
+    uint64_t sequences = 0;
+    for (int r = 0; r < reps; ++r) {
+        ExperimentRunner runner(cfg);
+        const auto t0 = std::chrono::steady_clock::now();
+        sequences = runner.sweep().sequences;
+        const auto t1 = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+    }
+    std::sort(seconds.begin(), seconds.end());
+
+    ThroughputCase c;
+    c.k = k;
+    c.trials = trials;
+    c.tests = tests;
+    c.threads = threads;
+    c.seconds = seconds[seconds.size() / 2];
+    c.trialsPerSec = static_cast<double>(sequences) * trials / c.seconds;
+    return c;
+}
+
+void write_json(std::ostream& os, const std::vector<ThroughputCase>& cases, const std::string& rev) {
+    os << "{\n  \"benchmark\": \"throughput\",\n  \"rev\": \"" << json_escape(rev) << "\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        const ThroughputCase& c = cases[i];
+        os << "    {\"k\": " << c.k << ", \"trials\": " << c.trials << ", \"tests\": \"" << c.tests
+           << "\", \"threads\": " << c.threads << ", \"seconds\": " << c.seconds
+           << ", \"trials_per_sec\": " << c.trialsPerSec << "}" << (i + 1 < cases.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+bool read_json_cases(const std::string& path, std::vector<ThroughputCase>& cases, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "could not read " + path;
+        return false;
+    }
+    std::stringstream buf;
+    buf << in.rdbuf();
+
+    JsonValue root;
+    if (!parse_json(buf.str(), root, err)) {
+        err = path + ": " + err;
+        return false;
+    }
+    const JsonValue* results = root.find("results");
+    if (!results || !results->is_array()) {
+        err = path + ": missing results array";
+        return false;
+    }
+
+    cases.clear();
+    for (const JsonValue& r : results->array) {
+        ThroughputCase c;
+        c.k = static_cast<int>(r.number_or("k", 0));
+        c.trials = static_cast<int>(r.number_or("trials", 0));
+        c.tests = r.string_or("tests", "all");
+        c.threads = static_cast<int>(r.number_or("threads", 1));
+        c.seconds = r.number_or("seconds", 0);
+        c.trialsPerSec = r.number_or("trials_per_sec", 0);
+        cases.push_back(c);
+    }
+    return true;
+}
+
+// Scaling curve: speedup and efficiency relative to the 1-thread case of the same config
+void print_scaling(const std::vector<ThroughputCase>& cases, const std::string& rev) {
+    std::cout << "\nShuffleLab — Throughput (" << rev << ")\n"
+              << "--------------------------------\n"
+              << std::right << std::setw(4) << "k" << std::setw(8) << "trials" << std::setw(12) << "tests"
+              << std::setw(9) << "threads" << std::setw(12) << "seconds" << std::setw(14) << "trials/s"
+              << std::setw(10) << "speedup" << std::setw(8) << "eff" << "\n";
+
+    for (const ThroughputCase& c : cases) {
+        double single = 0;
+        for (const ThroughputCase& o : cases) {
+            if (o.k == c.k && o.trials == c.trials && o.tests == c.tests && o.threads == 1) single = o.trialsPerSec;
+        }
+
+        std::cout << std::setw(4) << c.k << std::setw(8) << c.trials << std::setw(12) << c.tests
+                  << std::setw(9) << c.threads << std::fixed << std::setprecision(4) << std::setw(12) << c.seconds
+                  << std::setprecision(0) << std::setw(14) << c.trialsPerSec;
+        if (single > 0) {
+            const double speedup = c.trialsPerSec / single;
+            std::cout << std::setprecision(2) << std::setw(9) << speedup << "x"
+                      << std::setw(7) << std::setprecision(0) << 100 * speedup / c.threads << "%";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\n";
+}
+
+// Returns the number of regressions
+int compare_cases(std::ostream& os, const std::vector<ThroughputCase>& baseline, const std::vector<ThroughputCase>& current, double threshold) {
+    int regressions = 0;
+
+    os << "Comparison against baseline (threshold " << threshold << "%)\n"
+       << "--------------------------------\n";
+    for (const ThroughputCase& b : baseline) {
+        const std::string key = case_key(b);
+        auto it = std::find_if(current.begin(), current.end(), [&](const ThroughputCase& c) { return case_key(c) == key; });
+        if (it == current.end()) {
+            os << "  " << std::left << std::setw(48) << key << " not measured\n";
+            continue;
+        }
+
+        const double change = b.trialsPerSec > 0 ? 100.0 * (it->trialsPerSec / b.trialsPerSec - 1.0) : 0.0;
+        const bool regressed = change < -threshold;
+        regressions += regressed;
+
+        os << "  " << std::left << std::setw(48) << key << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << std::showpos << change << "%" << std::noshowpos
+                  << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    os << "\n" << regressions << " regression(s)\n";
+    return regressions;
+}
+
+} // namespace
+
+int run_throughput_bench(int argc, char** argv, const std::string& rev) {
+    ThroughputOptions opt;
+    auto toInt = [](const std::string& s) { return std::stoi(s); };
+    auto toStr = [](const std::string& s) { return s; };
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        auto need = [&](const char* flag) { return hasValue || (error(std::string(flag) + " requires a value"), false); };
+
+        if (std::strcmp(argv[i], "--e2e") == 0) {
+            continue;
+        }
+        else if (std::strcmp(argv[i], "--help") == 0) {
+            print_usage();
+            return 0;
+        }
+        else if (std::strcmp(argv[i], "--k-list") == 0) {
+            if (!need("--k-list")) return 1;
+            if (!parse_list(argv[++i], opt.ks, toInt)) return error("bad --k-list");
+            for (int k : opt.ks) {
+                if (k < ExperimentRunner::K_MIN || k > ExperimentRunner::K_MAX) return error("k out of range");
+            }
+        }
+        else if (std::strcmp(argv[i], "--trials-list") == 0) {
+            if (!need("--trials-list")) return 1;
+            if (!parse_list(argv[++i], opt.trials, toInt)) return error("bad --trials-list");
+            for (int t : opt.trials) {
+                if (t < 1) return error("trials must be at least 1");
+            }
+        }
+        else if (std::strcmp(argv[i], "--tests-list") == 0) {
+            if (!need("--tests-list")) return 1;
+            if (!parse_list(argv[++i], opt.tests, toStr)) return error("bad --tests-list");
+            for (const std::string& t : opt.tests) {
+                if (t != "all" && t != "uniformity" && t != "adjacency" && t != "mixing")
+                    return error("unknown test set: " + t);
+            }
+        }
+        else if (std::strcmp(argv[i], "--threads-list") == 0) {
+            if (!need("--threads-list")) return 1;
+            if (!parse_list(argv[++i], opt.threads, toInt)) return error("bad --threads-list");
+            for (int t : opt.threads) {
+                if (t < 1) return error("thread counts must be at least 1");
+            }
+        }
+        else if (std::strcmp(argv[i], "--reps") == 0) {
+            if (!need("--reps")) return 1;
+            opt.reps = std::stoi(argv[++i]);
+            if (opt.reps < 1) return error("--reps must be at least 1");
+        }
+        else if (std::strcmp(argv[i], "--save") == 0) {
+            if (!need("--save")) return 1;
+            opt.savePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--compare") == 0) {
+            if (!need("--compare")) return 1;
+            opt.comparePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--current") == 0) {
+            if (!need("--current")) return 1;
+            opt.currentPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threshold") == 0) {
+            if (!need("--threshold")) return 1;
+            opt.threshold = std::stod(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--format") == 0) {
+            if (!need("--format")) return 1;
+            opt.format = argv[++i];
+            if (opt.format != "text" && opt.format != "json") return error("--format must be text or json");
+        }
+        else {
+            return error(std::string("unknown option: ") + argv[i]);
+        }
+    }
+
+    if (!opt.currentPath.empty() && opt.comparePath.empty()) {
+        return error("--current requires --compare <baseline>");
+    }
+
+    if (opt.threads.empty()) {
+        const int hw = ThreadPool::resolve_threads(0);
+        for (int t = 1; t < hw; t *= 2) opt.threads.push_back(t);
+        opt.threads.push_back(hw);
+    }
+
+    // ----- Measure (or load) -----
+    std::vector<ThroughputCase> cases;
+    std::string err;
+    if (!opt.currentPath.empty()) {
+        if (!read_json_cases(opt.currentPath, cases, err)) return error(err);
+    } else {
+        for (int k : opt.ks)
+            for (int trials : opt.trials)
+                for (const std::string& tests : opt.tests)
+                    for (int threads : opt.threads)
+                        cases.push_back(measure(k, trials, tests, threads, opt.reps));
+    }
+
+    if (opt.format == "json") write_json(std::cout, cases, rev);
+    else print_scaling(cases, rev);
+
+    if (!opt.savePath.empty()) {
+        std::ofstream out(opt.savePath);
+        write_json(out, cases, rev);
+        if (!out) return error("could not write " + opt.savePath);
+    }
+
+    if (!opt.comparePath.empty()) {
+        std::vector<ThroughputCase> baseline;
+        if (!read_json_cases(opt.comparePath, baseline, err)) return error(err);
+        std::ostream& report = opt.format == "json" ? std::cerr : std::cout; // keep stdout valid JSON
+        if (compare_cases(report, baseline, cases, opt.threshold) > 0) return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "ExperimentRunner.h"
+
+// Minimal binary (de)serialisation for local state files (checkpoints, shard results).
+// Native endianness and layout - files are not meant to move between architectures.
+
+struct BinaryWriter {
+    std::FILE* f = nullptr;
+    bool ok = true;
+
+    template <typename T>
+    void put(const T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        ok = ok && std::fwrite(&v, sizeof(T), 1, f) == 1;
+    }
+
+    template <typename T>
+    void put_vec(const std::vector<T>& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<uint64_t>(v.size());
+        if (!v.empty()) ok = ok && std::fwrite(v.data(), sizeof(T), v.size(), f) == v.size();
+    }
+};
+
+struct BinaryReader {
+    std::FILE* f = nullptr;
+    bool ok = true;
+
+    template <typename T>
+    void get(T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        ok = ok && std::fread(&v, sizeof(T), 1, f) == 1;
+    }
+
+    template <typename T>
+    void get_vec(std::vector<T>& v, uint64_t maxSize) { // maxSize guards against corrupt lengths
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint64_t n = 0;
+        get(n);
+        if (!ok || n > maxSize) { ok = false; return; }
+        v.resize(n);
+        if (n > 0) ok = ok && std::fread(v.data(), sizeof(T), n, f) == n;
+    }
+};
+
+// DeckContext deck, accumulators and RNG state
+struct DeckContext;
+void put_context(BinaryWriter& w, const DeckContext& ctx);
+void get_context(BinaryReader& r, DeckContext& ctx);
+
+// Experiment identity: k, trials, tests, seed, game-cycle settings and shard
+void put_experiment(BinaryWriter& w, const ExperimentRunner::ExperimentConfig& cfg);
+void get_experiment(BinaryReader& r, ExperimentRunner::ExperimentConfig& cfg);
+
+// Writes to "<path>.tmp", syncs, then renames over path so a crash never leaves a torn file
+bool write_file_atomic(const std::string& path, const std::function<void(BinaryWriter&)>& body);
+
+// Opens path and runs body; false if the file is missing or body reports a read failure
+bool read_file(const std::string& path, const std::function<void(BinaryReader&)>& body);
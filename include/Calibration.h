@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Deck.h"
+#include "DeckUtils.h"
+#include "ShuffleModel.h"
+
+// ===== Model Calibration =====
+
+// Recorded shuffles, read from text files ('#' starts a comment):
+//   <table> <value>                    one observed packet size, e.g. "riffle 27", "hindu_drop 4"
+//   <shuffle> <52 cards> | <52 cards>  deck (top first, cards 0-51) before and after one
+//                                      cut, riffle, hindu or overhand
+struct CalibrationData {
+    std::array<std::vector<int>, MODEL_TABLES> samples; // packet sizes per ModelTable
+    std::array<std::vector<std::pair<Deck, Deck>>, 5> decks; // before/after per Shuffle
+    int records = 0;
+};
+
+// Appends the records in path; false with err ("path:line: ...") on a malformed line
+bool load_calibration_data(const std::string& path, CalibrationData& data, std::string& err);
+
+struct TableFit {
+    enum class Method { Default, Likelihood, Simulation };
+
+    ModelTable table = ModelTable::Cut;
+    Method method = Method::Default; // Default: no data, parameters unchanged
+    CdfParams params;
+    int records = 0;
+    double objective = 0; // mean log-likelihood per record, or simulated χ² distance
+};
+
+struct CalibrationOutcome {
+    std::array<TableFit, MODEL_TABLES> fits;
+    uint64_t candidates = 0;  // simulated parameter sets
+    uint64_t tablesBuilt = 0; // distinct CDF tables behind them
+    int rejected = 0;         // deck records the named shuffle cannot produce
+};
+
+// Maximum likelihood where the data pins a table's draws down (packet sizes, cuts and
+// riffles from deck orders), simulation-based fitting for hindu and overhand deck orders
+CalibrationOutcome calibrate(const CalibrationData& data, int threads, uint64_t seed);
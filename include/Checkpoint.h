@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Deck.h"
+#include "ExperimentRunner.h"
+
+// ===== Sweep Checkpoint =====
+
+// Everything needed to continue ExperimentRunner::run() exactly where it stopped.
+// Checkpoints are taken between sequences; each sequence reseeds its RNG from
+// (cfg.seed, sequence), so no per-trial RNG state is needed beyond the best context.
+struct Checkpoint {
+    ExperimentRunner::ExperimentConfig cfg{}; // identity fields (k, trials, tests, seed, shard) + outPath and ranking settings
+
+    bool complete = false;        // sweep finished - resume only reprints results
+    std::vector<int> idx;         // radix cursor: next sequence to evaluate
+    std::vector<ExperimentRunner::SequenceResult> results; // collected so far (result file runs only)
+    ExperimentRunner::Rankings rankings; // so far (--top / --weights runs only)
+
+    std::vector<int> bestSeqIdx;  // empty if no sequence evaluated yet
+    double bestScore = 0;
+    DeckContext bestShuffledDeck; // accumulators + RNG state of the best sequence
+};
+
+bool save_checkpoint(const std::string& path, const Checkpoint& cp);
+bool load_checkpoint(const std::string& path, Checkpoint& cp);
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include "DeckConstants.h"
 
 #include "Random.h" // PCG32
+#include "ShuffleModel.h"
 
 
 // ===== Definitions =====
@@ -22,11 +24,43 @@ static constexpr Deck CANONICAL_DECK = []{
 
 // ===== Deck and Functions =====
 
+// Outcome of one Hold'em deal (Stats.cpp) - what the accumulators record, packed
+struct PokerDeal {
+    std::array<uint8_t, POKER_MAX_SEATS> handClass{}; // HandClass per seat
+    uint16_t winners = 0; // seat bitmask, the pot is split between them
+};
+
+struct SampleTilt; // importance-sampling proposal (Exploit.h)
+
 struct DeckContext { // is DeckState more accurate?
     Deck deck = CANONICAL_DECK;
     Deck buffer{};
     PCG32 rng; 
     int numShuffles = 0;
+    const ShuffleModel* model = &default_model(); // sampling tables used by the human shuffles
+    SampleTilt* tilt = nullptr; // set: table draws come from the proposal and are reweighted (--track)
+    double quantile = -1; // >= 0: the next draw is taken at this quantile of its table (--stratify)
+
+    // One draw from model table t (every sample_cdf of the human shuffles); cdf is
+    // model->table(t), hoisted by kernels that draw from it in a loop
+    inline uint8_t sample(ModelTable t, const CdfTable& cdf) noexcept {
+        if (tilt) [[unlikely]] return tilted_sample(t, cdf);
+        if (quantile >= 0) [[unlikely]] return quantile_sample(cdf);
+        return rng.sample_cdf(cdf);
+    }
+    inline uint8_t sample(ModelTable t) noexcept { return sample(t, model->table(t)); }
+    uint8_t tilted_sample(ModelTable t, const CdfTable& cdf) noexcept; // Exploit.cpp
+    void tilted_interleave(int cutPoint) noexcept; // riffle's interleave under tilt (Exploit.cpp)
+
+    // Inverse CDF at quantile, as sample_cdf would map a draw there - used once, then cleared
+    inline uint8_t quantile_sample(const CdfTable& cdf) noexcept {
+        const int w = cdf[DECK_SIZE - 1];
+        const int r = std::min(w - 1, static_cast<int>(quantile * w));
+        quantile = -1;
+        int k = 0;
+        while (k < DECK_SIZE - 1 && r >= cdf[k]) ++k;
+        return static_cast<uint8_t>(k);
+    }
 
 
     inline void reset() { deck = CANONICAL_DECK; }   
@@ -38,6 +72,9 @@ struct DeckContext { // is DeckState more accurate?
     void overhand() noexcept;
     void random_test_shuffle() noexcept; // for testing stats
 
+    // Game Cycle: gather the deck after a Hold'em deal to seats (see Shuffle.cpp)
+    void collect_piles(int seats) noexcept;
+
     // Perfect Shuffles (Deterministic)
     void perfect_cut(uint8_t cutPoint = DECK_SIZE / 2) noexcept;
     void perfect_riffle() noexcept;
@@ -50,9 +87,20 @@ struct DeckContext { // is DeckState more accurate?
     std::array<std::array<int, DECK_SIZE>, DECK_SIZE> adjFreq{}; // (cardID, followerID)
     
     void observe_displacement() noexcept;
+    void observe_displacement(const Deck& before) noexcept; // distance moved from before's positions
     std::array<int, DECK_SIZE> dispHist{};
+
+    void observe_poker(int seats) noexcept; // deals one Hold'em hand to each seat
+    PokerDeal deal_poker(int seats) const noexcept; // the same deal, without recording it
+    void add_poker_deal(const PokerDeal& deal, int seats) noexcept;
+    std::array<std::array<int, POKER_HAND_CLASSES>, POKER_MAX_SEATS> pokerClassFreq{}; // (seat, hand class)
+    std::array<double, POKER_MAX_SEATS> pokerEquity{}; // pots won, split on ties
+    int pokerDeals = 0;
 };
 
+// Hash of every shuffle model parameter (Shuffle.cpp) - keys cached results
+uint64_t model_fingerprint() noexcept;
+
 // ===== Implementations =====
 
 // Shuffle.cpp
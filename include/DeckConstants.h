@@ -1,3 +1,7 @@
 #pragma once
 
-constexpr uint8_t DECK_SIZE = 52;
\ No newline at end of file
+constexpr uint8_t DECK_SIZE = 52;
+
+// Hold'em deal stage
+constexpr uint8_t POKER_MAX_SEATS = 10;
+constexpr uint8_t POKER_HAND_CLASSES = 9; // HandClass count (HandEvaluator.h)
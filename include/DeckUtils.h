@@ -67,4 +67,21 @@ constexpr std::string_view to_string(Shuffle s) {
         case Shuffle::RandomTest: return "RandomTest";
     }
     return "UNKNOWN";
-}
\ No newline at end of file
+}
+
+
+// How the deck is gathered between hands in game-cycle mode (--collect)
+enum class CollectModel : int {
+    Sorted, // fresh sorted deck every hand (independent trials)
+    Keep,   // cards stay in dealt order
+    Piles   // stub, then folded hands, burns and board as clumps
+};
+
+constexpr std::string_view to_string(CollectModel c) {
+    switch (c) {
+        case CollectModel::Sorted: return "sorted";
+        case CollectModel::Keep:   return "keep";
+        case CollectModel::Piles:  return "piles";
+    }
+    return "UNKNOWN";
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Deck.h"
+#include "DeckUtils.h"
+
+// ===== Exact Distributions =====
+
+// A distribution over deck orders held exactly: every reachable deck with its probability,
+// starting from the sorted deck. A shuffle's transitions are enumerated draw by draw with
+// the same arithmetic as its kernel in Shuffle.cpp, and decks reached by different draws
+// are merged. Cuts (one rotation per cut point) and overhands (a cut point, then every
+// sequence of drops - about 430k orders from one deck) can be enumerated; a riffle's
+// interleavings (~10^15 per deck) and a hindu's pickups (~10^10 each) never can.
+class ExactDistribution {
+public:
+    ExactDistribution(); // the sorted deck
+
+    // Most decks the distribution can hold after s: its support times s's orders per deck
+    // (infinite for riffles and hindus)
+    double bound_after(Shuffle s, const ShuffleModel& model) const;
+    ExactDistribution after(Shuffle s, const ShuffleModel& model) const;
+
+    std::size_t support() const { return decks.size(); }
+
+    // Deck at cumulative probability u in [0, 1), decks in lexicographic order
+    const Deck& at(double u) const;
+
+private:
+    std::vector<Deck> decks;        // sorted
+    std::vector<double> cumulative; // running probability, ends at 1
+};
+
+// The exact distributions after each sequence prefix a sweep meets, built once and shared
+// between threads. A prefix is tracked while the next shuffle cannot take the support past
+// budget decks; the first that could ends the exact part of every sequence through it.
+class ExactPrefixes {
+public:
+    explicit ExactPrefixes(std::size_t budget) : budget(budget) {}
+
+    // Distribution after seq's longest tracked prefix and its length (nullptr, 0 if none)
+    const ExactDistribution* longest(const std::vector<Shuffle>& seq, int& steps);
+
+    struct Tracked {
+        std::vector<Shuffle> prefix;
+        std::size_t support = 0;
+    };
+    std::vector<Tracked> tracked() const; // every prefix held, shortest first
+
+private:
+    struct Node {
+        std::once_flag once;
+        std::unique_ptr<ExactDistribution> dist; // null: over budget
+        std::vector<Shuffle> prefix;
+    };
+
+    std::size_t budget;
+    const ExactDistribution sorted;
+    mutable std::mutex mtx;
+    std::map<uint64_t, std::shared_ptr<Node>> nodes; // by prefix code (as sequence_code)
+};
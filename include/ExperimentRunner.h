@@ -1,16 +1,65 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "Deck.h"
 #include "Report.h"
 #include "DeckUtils.h"
+#include "ResultCache.h"
+
+struct Checkpoint;
+class ExactDistribution;
+class ExactPrefixes;
+class PermutationPool;
+class ThreadPool;
 
 class ExperimentRunner {
 public:
     static constexpr int K_MIN = 1;
     static constexpr int K_MAX = 8;
     static constexpr int TRIAL_MAX = 100;
+    static constexpr int STREAM_HANDS_MAX = 40000000; // 52 displacement counts per hand: 52 * 40M < INT_MAX
+    static constexpr int SEARCH_K_MAX = 20; // longest searched sequence (sequence_code: 3 bits per step)
+    static constexpr double TIME_BUDGET_MAX = 60; // seconds
+    static constexpr uint64_t SEARCH_EVALUATIONS_MAX = 20000; // sequences a --budget search simulates before stopping
+    static constexpr int BEAM_WIDTH_MAX = 10000;
+    static constexpr int BOOTSTRAP_MAX = 10000;
+    static constexpr int TOP_MAX = 1000;
+    static constexpr int REWEIGHTS_MAX = 16;
+    static constexpr int PREFIX_GROUP_DEPTH = 3; // trailing shuffles enumerated per task with --share-prefixes
+    static constexpr int OBJECTIVES = 4; // uniformity, adjacency, displacement, poker
+    static constexpr int TRACK_MAX = 16;
+    static constexpr int EXPLOIT_TRIALS_MAX = 100000000;
+    static constexpr int POOL_SIZE_MAX = 4000000; // 208 bytes per entry per shuffle
+    static constexpr int POOL_CHECK_SEQUENCES = 64;
+    static constexpr int STRATIFY_CHECK_SEQUENCES = 16;
+    static constexpr int STRATIFY_CHECK_REPLICATES = 16; // seeds per sequence and scheme
+    static constexpr int EXACT_BUDGET_MIN = 100;
+    static constexpr int EXACT_BUDGET_MAX = 4000000; // ~100 bytes per deck while a prefix is built
+
+    // Weight of each test in score() - only their ratios matter
+    struct ScoreWeights {
+        double uniformity = 0.25;
+        double adjacency = 0.7;
+        double displacement = 0.05;
+        double poker = 0.5;
+    };
+
+    // A targeted leak (--track): a card ending in a range of positions, a card dealt into
+    // one seat's hole cards, or two cards ending within a few positions of each other
+    struct TrackEvent {
+        enum class Kind { Position, Seat, Pair };
+        Kind kind = Kind::Position;
+        int card = 0;
+        int other = 0;      // Pair: the second card
+        int lo = 0, hi = 0; // Position: range (0 = top); Seat: seat (0-based) in lo; Pair: distance in lo
+    };
+
     struct ExperimentConfig {
         // configure in main to allow user specs
         int kMax;    // max shuffles per trial
@@ -19,22 +68,271 @@ public:
         bool testUniformity;
         bool testAdjacency;
         bool testMixing;
+        bool testPoker = false; // Hold'em deal stage, off unless named
+        int pokerSeats = 6;
+
+        // Game-cycle mode: consecutive hands per sequence, each deck collected from the
+        // previous deal (pokerSeats) and reshuffled, instead of independent sorted trials
+        int streamHands = 0;     // 0 = off
+        int streamWarmup = 100;  // hands played before statistics start
+        CollectModel collect = CollectModel::Piles;
+
+        uint64_t seed = 0; // master seed - each sequence draws from its own stream of it
+
+        std::string checkpointPath;  // empty = no checkpoints
+        int checkpointInterval = 60; // seconds between checkpoints
+
+        // Sharding: evaluate only slice shardIndex of shardCount of the n^k sequences
+        int shardIndex = 0;
+        int shardCount = 1;
+        std::string outPath; // partial result file for --merge (empty = don't write)
+
+        std::string cachePath; // on-disk result cache (empty = disabled)
+
+        int threads = 0; // worker threads for the sweep, 0 = all cores
+
+        bool profile = false; // time the hot path and print a breakdown (--profile)
+
+        // Pipelined mode: shuffle and stats stages on separate threads (0 = interleaved)
+        int pipelineShuffleWorkers = 0;
+        int pipelineStatsWorkers = 0;
+
+        // Time-budgeted search: best sequence whose shuffles fit in timeBudget seconds, any length
+        double timeBudget = 0; // 0 = off (exhaustive sweep of kMax)
+        std::array<double, 5> timeCost = {0, 2.0, 4.0, 6.0, 4.0}; // seconds per shuffle, indexed by Shuffle
+
+        // Beam search: keep the beamWidth best prefixes at each length up to beamLength
+        int beamWidth = 0; // 0 = off
+        int beamLength = SEARCH_K_MAX;
+
+        int bootstrap = 0; // bootstrap replicates per sequence for score intervals, 0 = off
+
+        ScoreWeights weights;
+        std::vector<ScoreWeights> reweights; // alternative weightings applied to the Pareto front
+        int top = 0; // sequences kept per test and by score (--top), 0 = off
+
+        std::vector<Shuffle> shuffles; // shuffle types to sequence (manifests), empty = all four
+
+        // Each sequence's trials continue from its prefix's trial decks, drawing only its
+        // last shuffle from its own stream, so sequences sharing a prefix simulate it once
+        bool sharePrefixes = false;
+
+        // Card tracking: probability of each track event after one given sequence, by
+        // importance sampling over exploitTrials sorted decks instead of a sweep
+        std::vector<Shuffle> exploitSequence; // empty = off
+        std::vector<TrackEvent> track;
+        int exploitTrials = 20000;
+
+        // Permutation pools: each shuffle a random pick from poolSize pre-sampled runs of
+        // it, applied as one gather, instead of simulated draw by draw (approximate)
+        int poolSize = 0;     // entries per shuffle, 0 = direct simulation
+        std::string poolPath; // kept on disk and memory-mapped (empty = built for this run)
+
+        // Latin-hypercube trials: each shuffle's leading draw (cut point, riffle split, hindu
+        // pickups, overhand packet) covers its table's quantiles evenly across a sequence's
+        // trials, one stratum per trial and step; the inner draws stay independent
+        bool stratify = false;
+
+        // Exact prefixes: the distribution after a sequence's leading cuts and overhands is
+        // enumerated while it holds at most exactBudget decks, and trials start from it
+        int exactBudget = 0; // 0 = off
+    };
+
+    // Summary of one evaluated sequence (kept for result files / merging)
+    struct SequenceResult {
+        uint64_t rank = 0;        // position in the radix enumeration
+        double uniformity = -1;   // -1 if the test is disabled
+        double adjacency = -1;
+        double displacement = -1;
+        double poker = -1;        // Hold'em χ² / df
+        double score = 0;
+    };
+
+    // Bootstrap over a sequence's trials (--bootstrap)
+    struct BootstrapResult {
+        uint64_t rank = 0;
+        double score = 0;          // point estimate
+        double low = 0, high = 0;  // 95% percentile interval
+        double pFirst = 0;         // share of replicates in which it scores best
+    };
+
+    // Kept during a sweep beyond its best (--top, --weights). The front holds every
+    // sequence no other beats on all enabled tests at once (distance to target), so the
+    // best sequence under any weighting is on it and can be found again without trials.
+    struct Rankings {
+        std::array<std::vector<SequenceResult>, OBJECTIVES> byObjective; // closest to target first
+        std::vector<SequenceResult> byScore; // best first
+        std::vector<SequenceResult> front;   // in rank order
+        std::vector<SequenceResult> reweighted; // best of the front per cfg.reweights, rescored
+    };
+
+    // What a sweep produced (no output printed)
+    struct SweepOutcome {
+        bool complete = false; // false if stopped by a signal (checkpoint written)
+        std::vector<int> bestSeqIdx;
+        double bestScore = 0;
+        DeckContext bestShuffledDeck;
+        std::vector<SequenceResult> results; // only when cfg.outPath is set
+        uint64_t sequences = 0;              // evaluated by this call
+        uint64_t cacheHits = 0, cacheMisses = 0, cacheEntries = 0;
+        std::vector<BootstrapResult> bootstrap; // every sequence, in rank order (--bootstrap)
+        Rankings rankings;                      // when cfg.top > 0 or cfg.reweights is set
+    };
+
+    // What a time-budgeted search produced (no output printed)
+    struct SearchOutcome {
+        std::vector<int> bestSeqIdx;
+        double bestScore = 0;
+        double bestTime = 0; // seconds the best sequence takes
+        DeckContext bestShuffledDeck;
+        uint64_t evaluated = 0; // sequences simulated
+        uint64_t pruned = 0;    // subtrees skipped on their lower bound
+        bool complete = true;   // false: stopped at SEARCH_EVALUATIONS_MAX, best found is not proven best
+        double feasible = 0;    // sequences within the budget (what exhaustive search would simulate)
+    };
+
+    // What a beam search produced (no output printed)
+    struct BeamOutcome {
+        struct Level {
+            std::vector<int> seqIdx; // best sequence of this length
+            double score = 0;
+        };
+        std::vector<Level> levels; // [length - 1]
+        std::vector<int> bestSeqIdx; // best over all lengths
+        double bestScore = 0;
+        DeckContext bestShuffledDeck;
+        uint64_t evaluated = 0; // sequences simulated
+    };
+
+    // What card tracking produced (no output printed)
+    struct ExploitOutcome {
+        struct Event {
+            double probability = 0;       // importance-sampling estimate
+            double low = 0, high = 0;     // 95% interval
+            uint64_t hits = 0;            // trials the event occurred in, under the proposal
+            double ess = 0;               // effective sample size of the weighted hits
+            double plainTrials = 0;       // plain Monte Carlo trials for the same interval
+            int rounds = 0;               // proposal refinements
+            bool tilted = false;          // false: the fit never converged or was rejected, estimate is plain Monte Carlo
+            bool rejected = false;        // fitted, but its check pilot or estimate varied no less than plain Monte Carlo
+            double directProbability = 0; // plain Monte Carlo over the same number of trials
+            uint64_t directHits = 0;
+        };
+        std::vector<Event> events; // as cfg.track
+        uint64_t trials = 0;       // per estimate
+        uint64_t pilotTrials = 0;  // spent fitting the proposals
+    };
 
+    // Pooled against direct simulation (--pool): the pool's error over a spread of
+    // sequences, next to the Monte Carlo noise the trial count already carries
+    struct PoolCheck {
+        int sequences = 0;
+        int length = 0;
+        double pooledRms = 0;   // RMS difference in log(1 + score), pooled vs direct
+        double noiseRms = 0;    // the same, direct vs direct under another seed
+        double poolError = 0;   // pooled error beyond that noise, sqrt(pooled^2 - noise^2)
+        double bias = 0;        // mean pooled - direct, in log(1 + score)
+        double bestPooled = 0, bestDirect = 0; // the best sequence's score
+    };
+
+    // Stratified against independent trials (--stratify): score variance over replicate
+    // seeds, so gain = independent trials one stratified trial is worth
+    struct StratifyCheck {
+        int sequences = 0;
+        int length = 0;
+        int replicates = 0;
+        double gain = 0;     // geometric mean over the sequences of var(independent) / var(stratified)
+        double bestGain = 0; // the best sequence's
     };
 
     explicit ExperimentRunner(const ExperimentConfig& cfg);
-    void run();
+
+    // score() is normalised by the weights of the enabled tests, so every weighting
+    // (cfg.weights and cfg.reweights) must give one of them a weight above 0
+    static bool weights_valid(const ExperimentConfig& cfg);
+    void run(const Checkpoint* resume = nullptr); // resume continues a stopped sweep
+    SweepOutcome sweep(const Checkpoint* resume = nullptr); // silent core of run()
+    SearchOutcome budget_search(); // silent core of run() in time-budget mode (Search.cpp)
+    BeamOutcome beam_search();     // silent core of run() in beam mode (Search.cpp)
+    ExploitOutcome exploit();      // silent core of run() in card-tracking mode (Exploit.cpp)
+    bool merge(const std::vector<std::string>& shardPaths, std::string& err); // --merge mode
+
+    // PermutationPool.cpp - builds or maps cfg.poolSize permutations per shuffle, after which every shuffle is
+    // drawn from them; reports whether they came from cfg.poolPath and how long it took
+    void prepare_pool(bool& mapped, double& seconds);
+    PoolCheck check_pool(const std::vector<int>& bestSeqIdx); // direct simulation is run for comparison
+    StratifyCheck check_stratify(const std::vector<int>& bestSeqIdx); // Stratified.cpp
+
+    // ExactDistribution.cpp - starts tracking exact prefixes (cfg.exactBudget), and what was tracked
+    void prepare_exact();
+    const ExactPrefixes* exact_prefixes() const { return exactPrefixes.get(); }
+
+    // Sweep on a caller's pool and result cache instead of its own (nullptr = own)
+    void share(ThreadPool* pool, ResultCache* cache);
+
+    // Given sequences (up to SEARCH_K_MAX shuffles of cfg.shuffles' types), in input order
+    // with rank = position - each one the same result a sweep gives it, cache included.
+    // reused counts results taken from the cache.
+    std::vector<SequenceResult> evaluate_batch(const std::vector<std::vector<Shuffle>>& seqs, uint64_t& reused);
+
+    int num_shuffles() const { return static_cast<int>(allowed.size()); }
+    std::vector<Shuffle> shuffles_of(const std::vector<int>& idx) const; // sweep indices -> shuffle types
+
+    // Radix enumeration helpers (idx[0] is the most significant digit)
+    static uint64_t num_sequences(int k, int base);
+    static uint64_t sequence_rank(const std::vector<int>& idx, int base);
+    static std::vector<int> sequence_from_rank(uint64_t rank, int k, int base);
+    static std::pair<uint64_t, uint64_t> shard_range(const ExperimentConfig& cfg, int base); // [begin, end)
+
+    // Same k, trials, tests, seed and simulation settings (shards of one experiment)
+    static bool same_experiment(const ExperimentConfig& a, const ExperimentConfig& b);
+
+    // Distance of each statistic from its target (0 for a disabled test)
+    static std::array<double, OBJECTIVES> deviations(const SequenceResult& r);
 
 private:
 
     
 
     ExperimentConfig cfg;
-    std::vector<Shuffle> allowed; // not yet configurable
+    std::vector<Shuffle> allowed; // cfg.shuffles, or every human shuffle
+    ThreadPool* sharedPool = nullptr;
+    ResultCache* sharedCache = nullptr;
+    std::shared_ptr<ThreadPool> ownPool; // cfg.threads workers when none are shared, made on first use
+    std::shared_ptr<const PermutationPool> permutations; // --pool, null = direct simulation
+    std::shared_ptr<ExactPrefixes> exactPrefixes;        // --exact, null = every step simulated
 
     void apply_shuffle(DeckContext& ctx, Shuffle s);
     bool next_sequence(std::vector<int>& idx, int base);
-    double score(double seqMeanUniformity, double seqMeanAdjacency, double seqMeanDisplacement);
+    uint64_t sequence_code(const std::vector<int>& idx) const;
+    ThreadPool& workers(); // sharedPool, else ownPool
+    std::vector<std::vector<int>> check_sequences(const std::vector<int>& bestSeqIdx, uint64_t count) const;
+    uint32_t tests_mask() const;
+    ResultCache::Key cache_key() const; // all but seqCode
+    void shuffle_trial(DeckContext& ctx, const std::vector<int>& idx);
+    void observe_trial(DeckContext& ctx, const Deck* collected = nullptr);
+    SequenceResult summarise(const DeckContext& ctx);
+    SequenceResult evaluate_sequence(DeckContext& ctx, const std::vector<int>& idx);
+    SequenceResult evaluate_stream(DeckContext& ctx, const std::vector<int>& idx);
+    SequenceResult evaluate_stratified(DeckContext& ctx, const std::vector<int>& idx); // Stratified.cpp
+    SequenceResult evaluate_exact(DeckContext& ctx, const std::vector<int>& idx, const ExactDistribution& dist, int steps); // ExactDistribution.cpp
+    uint64_t model_hash() const;
+    double score(double seqMeanUniformity, double seqMeanAdjacency, double seqMeanDisplacement, double seqPokerChiSqDf);
+    double score(const ScoreWeights& w, double seqMeanUniformity, double seqMeanAdjacency, double seqMeanDisplacement, double seqPokerChiSqDf);
+    bool keeps_rankings() const { return cfg.top > 0 || !cfg.reweights.empty(); }
+    void reweigh(Rankings& rankings); // fills rankings.reweighted
+    double score_lower_bound(double seqMeanAdjacency); // other enabled tests on target
+
+    // Bootstrap.cpp
+    SequenceResult evaluate_bootstrap(DeckContext& ctx, const std::vector<int>& idx, float* replicates);
+    void summarise_bootstrap(ThreadPool& pool, const std::vector<float>& replicates, std::vector<BootstrapResult>& results);
+
+    // Search.cpp
+    void extend_decks(DeckContext& ctx, const std::vector<Deck>& from, const std::vector<int>& idx, std::vector<Deck>& to);
+    SequenceResult evaluate_shared(DeckContext& ctx, const std::vector<int>& idx);
+    void evaluate_group(uint64_t firstRank, int depth, SequenceResult* out);
+    SequenceResult evaluate_node(DeckContext& ctx, const std::vector<int>& idx, double& pairsLow);
+    std::vector<double> pair_survival();
 };
 
 
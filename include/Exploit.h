@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Deck.h"
+#include "ExperimentRunner.h"
+
+// ===== Card Tracking =====
+
+// Importance sampling for rare leaks (--track). A model-table draw of the human shuffles
+// (DeckContext::sample) is taken from a proposal for its table and shuffle step instead,
+// and the trial carries the likelihood ratio of its draws, so events the model rarely
+// produces can be made common and reweighted back. Cut points (cut, riffle split, hindu
+// and overhand pickups) are proposed as offsets from the tracked card's position, so the
+// proposal follows the card wherever earlier shuffles left it; hindu pickup counts as
+// values. A riffle's interleave is tilted through one draw, the position the tracked card
+// lands at, with the other cards interleaved uniformly around it - the model's own
+// distribution given that position. Drop sizes are not tilted.
+struct SampleTilt {
+    static constexpr int LANDING = MODEL_TABLES;   // proposal slot of the riffle landing draw
+    static constexpr int SLOTS = MODEL_TABLES + 1; // model tables, then LANDING
+
+    struct Proposal {
+        bool fitted = false; // until fitted, draws come from the model
+        std::array<double, DECK_SIZE> probs{};    // over offsets (cut points), values or landing positions
+        std::array<uint32_t, DECK_SIZE> cdf{};    // value tables: probs mixed with the model,
+        std::array<double, DECK_SIZE> logRatio{}; // and log(model / proposal) per value
+    };
+
+    struct Draw {
+        uint8_t step, table, value; // value, or offset for cut points; table is a slot
+    };
+
+    int card = 0; // tracked card
+    std::vector<std::array<Proposal, SLOTS>> proposals; // [step][slot]
+    int step = 0;          // shuffle of the sequence being applied
+    double logWeight = 0;  // log likelihood ratio of the trial so far
+    bool record = false;   // keep draws (fitting the proposal)
+    std::vector<Draw> draws;
+
+    void begin_trial() {
+        step = 0;
+        logWeight = 0;
+        draws.clear();
+    }
+};
+
+// "pos:C:LO-HI", "seat:C:S" (1-based) or "pair:A:B[:D]"; cards as 0-51 or rank and
+// suit ("As", "Td", "7c")
+bool parse_track_event(const std::string& spec, ExperimentRunner::TrackEvent& out, std::string& err);
+
+std::string track_to_string(const ExperimentRunner::TrackEvent& e);
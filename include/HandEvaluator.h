@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Deck.h" // Card
+
+// ===== Texas Hold'em 7-Card Evaluator =====
+
+// Table driven: a suit with 5+ cards is looked up by its 13-bit rank mask (with 7
+// cards a flush rules out quads and full houses), anything else by a perfect hash
+// of the rank counts. Both tables map to one of the 4824 strengths a best-of-7 hand
+// can take.
+
+enum HandClass : uint8_t {
+    HighCard,
+    OnePair,
+    TwoPair,
+    Trips,
+    Straight,
+    Flush,
+    FullHouse,
+    Quads,
+    StraightFlush,
+    HAND_CLASSES
+};
+
+static_assert(HAND_CLASSES == POKER_HAND_CLASSES);
+
+using HandStrength = uint16_t; // 0 (weakest) .. 4823 (royal flush), higher wins
+
+// Rank counts and per-suit rank masks of a partial hand - a shared board is built
+// once and copied for every seat
+struct PartialHand {
+    std::array<uint8_t, 13> count{};   // by rank, deuce = 0 .. ace = 12
+    std::array<uint16_t, 4> suitMask{}; // ranks held in each suit
+
+    void add(Card c) noexcept;
+    HandStrength evaluate() const noexcept; // exactly 7 cards
+};
+
+HandStrength evaluate_7(const Card* cards) noexcept;
+HandClass hand_class(HandStrength s) noexcept;
+
+constexpr std::string_view to_string(HandClass c) {
+    switch (c) {
+        case HighCard:      return "High card";
+        case OnePair:       return "One pair";
+        case TwoPair:       return "Two pair";
+        case Trips:         return "Trips";
+        case Straight:      return "Straight";
+        case Flush:         return "Flush";
+        case FullHouse:     return "Full house";
+        case Quads:         return "Quads";
+        case StraightFlush: return "Straight flush";
+        default:            break;
+    }
+    return "UNKNOWN";
+}
+
+// Exact class probabilities of a uniformly random 7-card hand (counts / C(52,7))
+constexpr std::array<double, HAND_CLASSES> HAND_CLASS_PROB = {
+    23294460.0 / 133784560.0,
+    58627800.0 / 133784560.0,
+    31433400.0 / 133784560.0,
+     6461620.0 / 133784560.0,
+     6180020.0 / 133784560.0,
+     4047644.0 / 133784560.0,
+     3473184.0 / 133784560.0,
+      224848.0 / 133784560.0,
+       41584.0 / 133784560.0,
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// ===== Minimal JSON =====
+
+// Small DOM for the files and requests ShuffleLab reads (benchmark baselines,
+// manifests, daemon queries). Writers stream JSON directly and use json_escape.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object; // in file order
+
+    bool is_null() const { return type == Type::Null; }
+    bool is_number() const { return type == Type::Number; }
+    bool is_string() const { return type == Type::String; }
+    bool is_array() const { return type == Type::Array; }
+    bool is_object() const { return type == Type::Object; }
+
+    const JsonValue* find(const std::string& key) const; // nullptr if absent / not an object
+
+    double number_or(const std::string& key, double fallback) const;
+    std::string string_or(const std::string& key, const std::string& fallback) const;
+};
+
+bool parse_json(const std::string& text, JsonValue& out, std::string& err);
+
+std::string json_escape(const std::string& s); // without surrounding quotes
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "DeckUtils.h"
+#include "ExperimentRunner.h"
+#include "Json.h"
+
+// ===== Experiment Manifest =====
+
+// Many sweeps described in one JSON file and run in one process:
+//   {
+//     "threads": 0, "seed": 7, "cache": "nightly.slc",       (all optional)
+//     "defaults": { "trials": 100, "tests": ["adjacency"] }, (applied to every experiment)
+//     "experiments": [
+//       { "name": "riffles", "k": 6, "shuffles": ["cut", "riffle"] },
+//       { "name": "all", "k": 5, "weights": { "adjacency": 1 } }
+//     ]
+//   }
+// Experiment keys: name, k, trials, seed, tests, seats, stream, warmup, collect,
+// shuffles, weights, share_prefixes. Experiments without a seed share the
+// manifest's (random if absent).
+struct Manifest {
+    struct Experiment {
+        std::string name;
+        ExperimentRunner::ExperimentConfig cfg;
+    };
+
+    std::vector<Experiment> experiments;
+    int threads = 0;
+    std::string cachePath; // empty = results are shared in memory only
+    uint64_t seed = 0; // for experiments without their own
+};
+
+// false with err ("path: ...") if the file is unreadable or an entry is invalid
+bool load_manifest(const std::string& path, Manifest& manifest, std::string& err);
+
+// One experiment object (the keys above) applied on top of cfg; also used for daemon
+// requests. sawSeed is set if it names a seed.
+bool apply_experiment_keys(const JsonValue& obj, ExperimentRunner::ExperimentConfig& cfg, std::string& name, bool& sawSeed, std::string& err);
+
+// Combinations the command line also rejects
+bool check_experiment(const ExperimentRunner::ExperimentConfig& cfg, std::string& err);
+
+struct ManifestOutcome {
+    struct Experiment {
+        std::string name;
+        uint64_t sequences = 0;
+        uint64_t reused = 0; // taken from an earlier experiment or the cache file
+        std::vector<Shuffle> best;
+        double bestScore = 0;
+        double seconds = 0;
+    };
+
+    std::vector<Experiment> experiments;
+    uint64_t cacheEntries = 0;
+    double seconds = 0;
+};
+
+// Experiments run in file order, each sweep spread over one shared pool. Sequences
+// seed from (seed, shuffle types), so an evaluation an earlier experiment made - same
+// sequence, trials, seed, tests and game-cycle settings, whatever its shuffle subset or
+// weights - comes from the shared result cache instead of being simulated again.
+ManifestOutcome run_manifest(const Manifest& manifest);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Deck.h"
+#include "DeckUtils.h"
+
+class ThreadPool;
+
+// ===== Permutation Pools =====
+
+// The human shuffles move cards by position alone - no draw looks at which card sits
+// where - so one run of a shuffle is a permutation of positions, deck'[i] = deck[perm[i]].
+// A pool holds size runs of each human shuffle, sampled once from a sorted deck; a
+// trial's shuffle then picks an entry at random and gathers the deck through it (--pool).
+// Every trial draws from the same finite sample, which adds an error direct simulation
+// does not have - ExperimentRunner::check_pool measures it. Saved pools are read back
+// through a read-only memory map, checked once on load, and shared with the page cache.
+class PermutationPool {
+public:
+    static constexpr int SHUFFLES = 4; // cut, riffle, hindu, overhand (RandomTest is never pooled)
+
+    PermutationPool() = default;
+    ~PermutationPool();
+
+    PermutationPool(const PermutationPool&) = delete;
+    PermutationPool& operator=(const PermutationPool&) = delete;
+
+    // size entries per shuffle from seed's streams, in fixed chunks across the pool's
+    // threads - the same pool for any thread count
+    void build(uint32_t size, uint64_t seed, ThreadPool& pool);
+
+    // Maps path if it holds a pool of size entries sampled from the current model
+    // parameters, each a permutation of 0..51 matching the stored hash; false (nothing mapped) for a missing,
+    // foreign, stale or corrupt file
+    bool load(const std::string& path, uint32_t size);
+    bool save(const std::string& path) const;
+
+    uint32_t size() const { return entries; }
+    uint64_t fingerprint() const { return hash; } // of the model and every entry - keys cached results
+
+    const uint8_t* entry(Shuffle s, uint32_t i) const {
+        return data + (static_cast<std::size_t>(static_cast<int>(s) - 1) * entries + i) * DECK_SIZE;
+    }
+
+    // One shuffle of ctx.deck: a uniformly chosen entry, applied as a single gather
+    void apply(DeckContext& ctx, Shuffle s) const noexcept {
+        const uint8_t* perm = entry(s, ctx.rng.random_bounded(entries));
+        for (int i = 0; i < DECK_SIZE; ++i) ctx.buffer[i] = ctx.deck[perm[i]];
+        ctx.deck = ctx.buffer;
+    }
+
+private:
+    std::vector<uint8_t> owned;    // built in this process
+    const uint8_t* data = nullptr; // [shuffle][entry][position], owned or mapped
+    uint32_t entries = 0;
+    uint64_t hash = 0;
+
+    void* mapBase = nullptr;
+    std::size_t mapLength = 0;
+
+    void unmap();
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Deck.h"
+#include "SpscRing.h"
+
+// ===== Pipelined Shuffle -> Statistics Execution =====
+
+// Shuffle workers produce finished decks; stats workers drain them in batches into
+// their own accumulators. Every (shuffle worker, stats worker) pair has its own SPSC
+// ring, and job j's decks all go to stats worker j % statsWorkers, so one job is
+// accumulated by exactly one thread and the two stages can be sized independently.
+
+struct PipelineSlot {
+    uint32_t job = 0;
+    uint32_t numShuffles = 0; // set on the end-of-job slot
+    bool last = false;        // end of job - accumulator is complete
+    Deck deck{};
+};
+
+// Where a shuffle worker sends the decks of its current job
+class DeckSink {
+public:
+    void push(const Deck& deck); // blocks (spins, then yields) while the ring is full
+
+private:
+    friend class DeckPipeline;
+    SpscRing<PipelineSlot>* ring = nullptr;
+    uint32_t job = 0;
+};
+
+class DeckPipeline {
+public:
+    struct Stages {
+        // Shuffle side: simulate job into ctx (rng seeded by the callee), push every deck
+        std::function<void(std::size_t job, DeckContext& ctx, DeckSink& sink)> produce;
+        // Stats side: accumulate acc.deck into acc
+        std::function<void(DeckContext& acc)> observe;
+        // Stats side: all of job's decks are in acc (numShuffles as counted by produce)
+        std::function<void(std::size_t job, const DeckContext& acc)> finish;
+    };
+
+    DeckPipeline(int shuffleWorkers, int statsWorkers, std::size_t ringCapacity = 256);
+    ~DeckPipeline();
+
+    DeckPipeline(const DeckPipeline&) = delete;
+    DeckPipeline& operator=(const DeckPipeline&) = delete;
+
+    int shuffle_workers() const { return numShuffle; }
+    int stats_workers() const { return numStats; }
+
+    // Every job in [0, jobs) produced and finished, blocks until done
+    void run(std::size_t jobs, const Stages& stages);
+
+private:
+    int numShuffle;
+    int numStats;
+    std::vector<std::unique_ptr<SpscRing<PipelineSlot>>> rings; // [shuffle * numStats + stats]
+
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable cv;
+    uint64_t generation = 0; // bumped per run()
+    int active = 0;          // workers still inside the current run
+    bool stopping = false;
+
+    // Current run (valid while active > 0)
+    const Stages* stages = nullptr;
+    std::size_t jobCount = 0;
+    std::atomic<std::size_t> nextJob{0};
+    std::atomic<int> shufflersDone{0};
+
+    void worker_loop(int worker);
+    void shuffle_worker(int s);
+    void stats_worker(int c);
+};
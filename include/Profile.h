@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "DeckUtils.h" // Shuffle
+
+// ===== Hot-path Profiling (--profile) =====
+
+// Scoped timers around the shuffle / observe / report calls of a sweep, with optional
+// Linux hardware counters (perf_event_open). Build with -DSHUFFLELAB_PROFILING=0 to
+// compile every PROFILE_SCOPE out; otherwise a disabled scope costs one predictable branch.
+
+#ifndef SHUFFLELAB_PROFILING
+#define SHUFFLELAB_PROFILING 1
+#endif
+
+namespace profile {
+
+enum Stage : uint8_t {
+    ShuffleCut,
+    ShuffleRiffle,
+    ShuffleHindu,
+    ShuffleOverhand,
+    ShuffleRandomTest,
+    ObserveUniformity,
+    ObserveAdjacency,
+    ObserveDisplacement,
+    ObservePoker,
+    ReportUniformity,
+    ReportAdjacency,
+    ReportDisplacement,
+    ReportPoker,
+    STAGE_COUNT
+};
+
+enum Counter : uint8_t { Cycles, Instructions, BranchMisses, L1DMisses, COUNTER_COUNT };
+
+inline bool enabled = false; // set before any worker starts, read-only during a sweep
+
+void enable(); // turns profiling on and probes hardware counters
+bool counters_available();
+
+constexpr Stage shuffle_stage(Shuffle s) {
+    switch (s) {
+        case Shuffle::Cut:        return ShuffleCut;
+        case Shuffle::Riffle:     return ShuffleRiffle;
+        case Shuffle::Hindu:      return ShuffleHindu;
+        case Shuffle::Overhand:   return ShuffleOverhand;
+        case Shuffle::RandomTest: return ShuffleRandomTest;
+    }
+    return ShuffleRandomTest;
+}
+
+// Per-thread accumulation (merged by print_report)
+void begin_scope(uint64_t counters[COUNTER_COUNT]);
+void end_scope(Stage stage, std::chrono::steady_clock::time_point start, const uint64_t counters[COUNTER_COUNT]);
+
+void reset();
+void print_report(double wallSeconds);
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) noexcept : stage(stage) {
+        if (!enabled) return;
+        begin_scope(counters);
+        start = std::chrono::steady_clock::now(); // after the counter read, so it isn't timed
+    }
+
+    ~ScopedTimer() {
+        if (!enabled) return;
+        end_scope(stage, start, counters);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage;
+    std::chrono::steady_clock::time_point start{};
+    uint64_t counters[COUNTER_COUNT] = {};
+};
+
+} // namespace profile
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if SHUFFLELAB_PROFILING
+#define PROFILE_SCOPE(stage) ::profile::ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(stage)
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#endif
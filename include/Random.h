@@ -32,6 +32,23 @@ struct PCG32 {
             state = rd();
         }
 
+        // Deterministic seeding (pcg32_srandom) - initSeq selects an independent stream
+        inline void seed(uint64_t initState, uint64_t initSeq = 1) noexcept {
+            state = 0;
+            increment = (initSeq << 1u) | 1u;
+            next();
+            state += initState;
+            next();
+        }
+
+        // Raw state access (checkpointing)
+        inline uint64_t get_state() const noexcept { return state; }
+        inline uint64_t get_increment() const noexcept { return increment; }
+        inline void set_state(uint64_t s, uint64_t inc) noexcept {
+            state = s;
+            increment = inc | 1u;
+        }
+
         inline uint32_t random_bounded(uint32_t bound) noexcept { // can we guarantee uniform distribution on bound
             return next() % bound; // returns [0, bound)
         }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "ExperimentRunner.h"
+
+// ===== Rankings =====
+
+// Builds ExperimentRunner::Rankings one result at a time: a bounded max-heap per list
+// (the root is the worst entry kept, replaced when beaten) and an incremental Pareto
+// front. Ties go to the lower rank and the front does not depend on offer order, so
+// the rankings match between thread counts, shards and resumed runs.
+class RankingTracker {
+public:
+    using SequenceResult = ExperimentRunner::SequenceResult;
+
+    explicit RankingTracker(std::size_t k) : k(k) {}
+
+    void offer(const SequenceResult& r);
+    void restore(const ExperimentRunner::Rankings& saved); // continue from a checkpoint's lists
+    ExperimentRunner::Rankings rankings() const;
+
+private:
+    struct Entry {
+        double key;
+        SequenceResult result;
+    };
+
+    using Deviations = std::array<double, ExperimentRunner::OBJECTIVES>;
+
+    void push_bounded(std::vector<Entry>& heap, double key, const SequenceResult& r);
+    void offer_front(const SequenceResult& r, const Deviations& dev);
+    std::vector<SequenceResult> sorted(const std::vector<Entry>& heap) const;
+
+    std::size_t k;
+    std::array<std::vector<Entry>, ExperimentRunner::OBJECTIVES> objectiveHeaps;
+    std::vector<Entry> scoreHeap;
+
+    std::vector<SequenceResult> front;
+    std::vector<Deviations> frontDeviations;
+};
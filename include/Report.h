@@ -29,4 +29,19 @@ struct DisplacementReport {
 };
 DisplacementReport report_displacement(const DeckContext& ctx);
 
-void print_report(const DisplacementReport& r);
\ No newline at end of file
+void print_report(const DisplacementReport& r);
+
+
+struct PokerReport {
+    int seats = 0;
+    int deals = 0;
+    std::array<std::array<double, POKER_HAND_CLASSES>, POKER_MAX_SEATS> classFreq{}; // share of deals
+    std::array<double, POKER_MAX_SEATS> equity{}; // share of pots won
+    double maxClassDev = 0;  // largest |share - uniform share| over seats and classes
+    double maxEquityDev = 0; // largest |equity - 1/seats|
+    double chiSq = 0;        // hand classes per seat + pot share per seat
+    int df = 0;
+    double reducedChiSq = 0; // chiSq / df, ≈ 1 for a uniform deal
+};
+PokerReport report_poker(const DeckContext& ctx, int seats);
+void print_report(const PokerReport& r);
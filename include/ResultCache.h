@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ===== On-Disk Sequence Result Cache =====
+
+// Content-addressed store of sequence evaluations. A sequence's result is a pure
+// function of the key below (RNG streams derive from seed + sequence), so any
+// run with a matching key can reuse it. The file is a sorted array of fixed-size
+// records searched in place through a read-only memory map; new entries are held
+// in memory and merged into the file by flush(). Safe to share between threads -
+// lookups run concurrently, inserts and flushes take the cache exclusively.
+class ResultCache {
+public:
+    struct Key {
+        uint64_t modelHash = 0; // model_fingerprint() - any create_cdf change misses
+        uint64_t seqCode = 0;   // shuffle sequence (ExperimentRunner::sequence_code)
+        uint64_t seed = 0;
+        uint32_t trials = 0;
+        uint32_t tests = 0;     // bitmask of enabled tests (+ poker seats << 8)
+    };
+
+    struct Value {
+        double uniformity = -1;
+        double adjacency = -1;
+        double displacement = -1;
+        double poker = -1;
+    };
+
+    explicit ResultCache(const std::string& path); // maps the file if it exists
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    bool lookup(const Key& key, Value& value) const;
+    void insert(const Key& key, const Value& value);
+    bool flush(); // merge pending entries into the file (atomic replace) and remap
+
+    std::size_t size() const {
+        std::shared_lock lock(mtx);
+        return mappedCount + pending.size();
+    }
+
+    struct Record {
+        uint64_t hash; // content address of key
+        Key key;
+        Value value;
+    };
+
+private:
+    std::string path; // empty = in memory only
+    mutable std::shared_mutex mtx;
+
+    const Record* mapped = nullptr; // sorted by (hash, key)
+    std::size_t mappedCount = 0;
+    void* mapBase = nullptr;
+    std::size_t mapLength = 0;
+
+    std::vector<Record> pending; // not yet in the file, sorted on flush
+    std::unordered_multimap<uint64_t, std::size_t> pendingIndex; // hash -> pending slot
+
+    void map_file();
+    void unmap_file();
+};
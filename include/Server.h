@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+// ===== Query Daemon =====
+
+// Long-lived process holding the model tables, one worker pool and one result cache,
+// answering newline-delimited JSON requests on a Unix domain socket - one response line
+// per request line, connections served concurrently on the shared pool:
+//   {"op": "score", "sequences": [["riffle", "riffle", "cut"]], "trials": 100}
+//   {"op": "best", "k": 5, "shuffles": ["cut", "riffle"], "top": 3}
+//   {"op": "status"}   {"op": "ping"}   {"op": "shutdown"}
+// score and best take the manifest's experiment keys (k, trials, seed, tests, seats,
+// stream, warmup, collect, shuffles, share_prefixes, weights) with the --run defaults,
+// except that the seed defaults to 0 so repeated queries are answered from the cache.
+// Responses: {"ok": true, ..., "ms": <time taken>} or {"ok": false, "error": "..."}.
+struct ServerOptions {
+    std::string socketPath;
+    int threads = 0;       // 0 = all cores
+    std::string cachePath; // empty = results kept in memory for the daemon's lifetime
+};
+
+// Serves until SIGINT, SIGTERM or a shutdown request; false with err if the socket
+// cannot be set up (another daemon still listening on it, path too long, ...)
+bool serve(const ServerOptions& options, std::string& err);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Deck.h"
+#include "ExperimentRunner.h"
+
+// ===== Shard Result File =====
+
+// Output of one (possibly sharded) sweep: every evaluated sequence plus the shard's best
+// context, enough for --merge to rebuild the global ranking without re-simulating.
+// Sequences seed from (cfg.seed, sequence), so merged shards match an unsharded run.
+struct ShardResult {
+    ExperimentRunner::ExperimentConfig cfg{}; // identity fields (k, trials, tests, seed, shard)
+
+    std::vector<ExperimentRunner::SequenceResult> results; // in enumeration order
+
+    std::vector<int> bestSeqIdx; // empty if the shard was empty
+    double bestScore = 0;
+    DeckContext bestShuffledDeck;
+};
+
+bool save_shard_result(const std::string& path, const ShardResult& r);
+bool load_shard_result(const std::string& path, ShardResult& r);
+
+// Combine a complete set of shards (0..N-1 of the same experiment) into one result.
+// Results are ordered by score (ties by enumeration rank, as an unsharded run picks).
+// Returns false with a message in err if the shards don't fit together.
+bool merge_shard_results(const std::vector<ShardResult>& shards, int base, ShardResult& merged, std::string& err);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "DeckConstants.h"
+
+// ===== Shuffle Model Tables =====
+
+// Sampling tables of the human shuffles (Shuffle.cpp), each built by create_cdf (Random.h)
+using CdfTable = std::array<uint16_t, DECK_SIZE>;
+
+enum class ModelTable : int {
+    Cut,
+    Riffle,       // packet split
+    HinduOps,     // packet pickups per shuffle
+    HinduCut,     // cards taken off the top per pickup
+    HinduDrop,    // cards dropped at a time (a count, not an idx)
+    OverhandCut,
+    OverhandDrop,
+    COUNT
+};
+constexpr int MODEL_TABLES = static_cast<int>(ModelTable::COUNT);
+
+constexpr std::string_view to_string(ModelTable t) { // also the names used in calibration files
+    switch (t) {
+        case ModelTable::Cut:          return "cut";
+        case ModelTable::Riffle:       return "riffle";
+        case ModelTable::HinduOps:     return "hindu_ops";
+        case ModelTable::HinduCut:     return "hindu_cut";
+        case ModelTable::HinduDrop:    return "hindu_drop";
+        case ModelTable::OverhandCut:  return "overhand_cut";
+        case ModelTable::OverhandDrop: return "overhand_drop";
+        case ModelTable::COUNT:        break;
+    }
+    return "UNKNOWN";
+}
+
+// create_cdf(min, max, centre, spread) arguments
+struct CdfParams {
+    int min = 0;
+    int max = DECK_SIZE;
+    int centre = DECK_SIZE / 2;
+    double spread = 1;
+};
+
+// One table per ModelTable. Tables are referenced, not owned, so candidate models can
+// share them (calibration) - DeckContext::model points at the one in use.
+struct ShuffleModel {
+    std::array<const CdfTable*, MODEL_TABLES> tables{};
+
+    const CdfTable& table(ModelTable t) const noexcept { return *tables[static_cast<int>(t)]; }
+};
+
+const ShuffleModel& default_model() noexcept;
+CdfParams default_params(ModelTable t) noexcept;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// ===== Single-Producer / Single-Consumer Ring =====
+
+// Bounded lock-free queue for exactly one pushing and one popping thread. Head and
+// tail live on separate cache lines, and each side caches the other's index so the
+// shared line is only touched when the ring looks full (producer) or empty (consumer).
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) : slots(round_up_pow2(capacity)), mask(slots.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return slots.size(); }
+
+    // Producer: false if full
+    bool try_push(const T& item) {
+        const std::size_t t = tail.value.load(std::memory_order_relaxed);
+        if (t - headCache == slots.size()) {
+            headCache = head.value.load(std::memory_order_acquire);
+            if (t - headCache == slots.size()) return false;
+        }
+        slots[t & mask] = item;
+        tail.value.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: fn(item) on up to maxItems queued items, released with one store
+    template <typename Fn>
+    std::size_t drain(Fn&& fn, std::size_t maxItems) {
+        const std::size_t h = head.value.load(std::memory_order_relaxed);
+        if (tailCache == h) {
+            tailCache = tail.value.load(std::memory_order_acquire);
+            if (tailCache == h) return 0;
+        }
+        std::size_t n = tailCache - h;
+        if (n > maxItems) n = maxItems;
+        for (std::size_t i = 0; i < n; ++i) fn(slots[(h + i) & mask]);
+        head.value.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Index {
+        std::atomic<std::size_t> value{0};
+    };
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    std::vector<T> slots;
+    const std::size_t mask;
+
+    Index head;                                  // next slot to pop (written by consumer)
+    alignas(CACHE_LINE) std::size_t tailCache = 0; // consumer's copy of tail
+    Index tail;                                  // next slot to push (written by producer)
+    alignas(CACHE_LINE) std::size_t headCache = 0; // producer's copy of head
+};
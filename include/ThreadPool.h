@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===== Worker Pool =====
+
+// Fixed set of workers fed from one task queue. parallel_for() may be called from
+// several threads at once (or from inside a task) - the caller always works on its
+// own loop, so it finishes even when every worker is busy elsewhere.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads); // total threads incl. the caller, 0 = all cores
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // fn(i) for every i in [0, n), blocks until all calls have returned
+    void parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn);
+
+    void submit(std::function<void()> task); // fire and forget
+
+    static int resolve_threads(int threads); // 0 -> hardware concurrency
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    void worker_loop();
+};
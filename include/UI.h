@@ -1,11 +1,15 @@
 #pragma once
 
+#include "Calibration.h"
 #include "Deck.h"
 #include "DeckUtils.h"
+#include "ExactDistribution.h"
 #include "ExperimentRunner.h"
+#include "Manifest.h"
 #include "Report.h"
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 // ===== Output =====
@@ -16,6 +20,30 @@ void print_experiment_overview(const ExperimentRunner::ExperimentConfig& cfg, in
 
 void print_experiment_results(const ExperimentRunner::ExperimentConfig& cfg, const DeckContext& ctx, const std::vector<int>& bestShuffleSeqIdx, int numShufflesAllowed);
 
+void print_search_summary(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::SearchOutcome& outcome);
+
+void print_beam_summary(const ExperimentRunner::BeamOutcome& outcome);
+
+void print_exploit(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::ExploitOutcome& outcome);
+
+void print_calibration(const CalibrationData& data, const CalibrationOutcome& outcome, std::size_t files);
+
+void print_bootstrap(const ExperimentRunner::ExperimentConfig& cfg, std::vector<ExperimentRunner::BootstrapResult> results, int numShufflesAllowed, std::size_t count);
+
+void print_pool_check(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::PoolCheck& check);
+
+void print_stratify_check(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::StratifyCheck& check);
+
+void print_exact_prefixes(const ExperimentRunner::ExperimentConfig& cfg, const std::vector<ExactPrefixes::Tracked>& tracked);
+
+void print_manifest(const Manifest& manifest, const ManifestOutcome& outcome);
+
+void print_rankings(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::Rankings& rankings, int numShufflesAllowed);
+
+std::string weights_to_string(const ExperimentRunner::ScoreWeights& w);
+
+void print_ranking(const std::vector<ExperimentRunner::SequenceResult>& ranked, int k, int numShufflesAllowed, std::size_t count);
+
 void print_help();
 
 void print_desc();
@@ -1,13 +1,21 @@
 #include <iostream>
 #include <string>
-#include <cstring>   // strcmp
+#include <vector>
+#include <cstring>   // strcmp, strncmp
 #include <cstdlib>   // std::stoi
+#include <random>    // std::random_device
 
 #include "Deck.h"
 #include "DeckUtils.h"
 #include "Report.h"
 #include "UI.h"
 #include "ExperimentRunner.h"
+#include "Calibration.h"
+#include "Checkpoint.h"
+#include "Exploit.h"
+#include "Manifest.h"
+#include "Profile.h"
+#include "Server.h"
 
 
 // Error Helper
@@ -23,9 +31,21 @@ int main(int argc, char** argv) {
     bool wantHelp = false;
     bool wantDesc = false;
     bool wantRun = false;
+    bool wantMerge = false;
+    std::vector<std::string> mergePaths;
+    bool wantCalibrate = false;
+    std::vector<std::string> calibrationPaths;
+    bool wantManifest = false;
+    std::string manifestPath;
+    bool wantServe = false;
+    std::string socketPath;
 
     // Track whether any experiment-related flag was seen
     bool sawExperimentFlag = false;
+    bool sawPoolFlag = false; // --threads / --cache, also valid with --serve
+    bool sawIdentityFlag = false; // flags that define the experiment (fixed when resuming)
+    bool sawSeed = false;
+    std::string resumePath;
 
     // ----- Experiment configuration -----
     ExperimentRunner::ExperimentConfig cfg;
@@ -35,6 +55,16 @@ int main(int argc, char** argv) {
     cfg.testUniformity = true;
     cfg.testAdjacency  = true;
     cfg.testMixing     = true;
+    bool sawTestToggle = false; // any toggle selects only the named tests
+    bool sawSeats = false;
+    bool sawCycleOption = false; // --warmup / --collect
+    bool sawK = false;
+    bool sawTimeCosts = false;
+    bool sawLength = false;
+    bool sawRankingFlag = false; // --weights / --top, also valid with --merge
+    bool sawTrials = false;
+    bool sawExploitTrials = false;
+    int weightSets = 0;
 
     // ----- Parse arguments -----
     for (int i = 1; i < argc; ++i) {
@@ -49,6 +79,32 @@ int main(int argc, char** argv) {
         else if (std::strcmp(argv[i], "--run") == 0) {
             wantRun = true;
         }
+        else if (std::strcmp(argv[i], "--merge") == 0) {
+            wantMerge = true;
+            // consume shard files up to the next option
+            while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                mergePaths.emplace_back(argv[++i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--calibrate") == 0) {
+            wantCalibrate = true;
+            while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                calibrationPaths.emplace_back(argv[++i]);
+            }
+        }
+
+        else if (std::strcmp(argv[i], "--manifest") == 0) {
+            if (i + 1 >= argc)
+                return error("--manifest requires a file path");
+            wantManifest = true;
+            manifestPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--serve") == 0) {
+            if (i + 1 >= argc)
+                return error("--serve requires a socket path");
+            wantServe = true;
+            socketPath = argv[++i];
+        }
 
         // ---- Experiment parameters ----
         else if (std::strcmp(argv[i], "--k") == 0) {
@@ -67,12 +123,16 @@ int main(int argc, char** argv) {
             }
 
             sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            sawK = true;
             cfg.kMax = k;
         }
         else if (std::strcmp(argv[i], "--trials") == 0) {
             if (i + 1 >= argc)
                 return error("--trials requires an integer value");
             sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            sawTrials = true;
     
             int trial = std::stoi(argv[++i]);
 
@@ -89,16 +149,428 @@ int main(int argc, char** argv) {
         // ---- Test toggles ----
         else if (std::strcmp(argv[i], "--uniformity") == 0) {
             sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            if (!sawTestToggle) {
+                sawTestToggle = true;
+                cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = false;
+            }
             cfg.testUniformity = true;
         }
         else if (std::strcmp(argv[i], "--adjacency") == 0) {
             sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            if (!sawTestToggle) {
+                sawTestToggle = true;
+                cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = false;
+            }
             cfg.testAdjacency = true;
         }
         else if (std::strcmp(argv[i], "--mixing") == 0) {
             sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            if (!sawTestToggle) {
+                sawTestToggle = true;
+                cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = false;
+            }
             cfg.testMixing = true;
         }
+        else if (std::strcmp(argv[i], "--poker") == 0) {
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            if (!sawTestToggle) {
+                sawTestToggle = true;
+                cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = false;
+            }
+            cfg.testPoker = true;
+        }
+        else if (std::strcmp(argv[i], "--seats") == 0) {
+            if (i + 1 >= argc)
+                return error("--seats requires an integer value");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+
+            int seats = std::stoi(argv[++i]);
+            if (seats < 2 || seats > POKER_MAX_SEATS) {
+                return error("seats must be between 2 and " + std::to_string(POKER_MAX_SEATS));
+            }
+            cfg.pokerSeats = seats;
+            sawSeats = true;
+        }
+
+        // ---- Game cycle ----
+        else if (std::strcmp(argv[i], "--stream") == 0) {
+            if (i + 1 >= argc)
+                return error("--stream requires an integer value");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+
+            int hands = std::stoi(argv[++i]);
+            if (hands < 1 || hands > ExperimentRunner::STREAM_HANDS_MAX) {
+                return error("stream hands must be between 1 and " + std::to_string(ExperimentRunner::STREAM_HANDS_MAX));
+            }
+            cfg.streamHands = hands;
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0) {
+            if (i + 1 >= argc)
+                return error("--warmup requires an integer value");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            sawCycleOption = true;
+
+            int warmup = std::stoi(argv[++i]);
+            if (warmup < 0 || warmup > ExperimentRunner::STREAM_HANDS_MAX) {
+                return error("warmup must be between 0 and " + std::to_string(ExperimentRunner::STREAM_HANDS_MAX));
+            }
+            cfg.streamWarmup = warmup;
+        }
+        else if (std::strcmp(argv[i], "--collect") == 0) {
+            if (i + 1 >= argc)
+                return error("--collect requires sorted, keep or piles");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            sawCycleOption = true;
+
+            const std::string model = argv[++i];
+            if (model == "sorted")     cfg.collect = CollectModel::Sorted;
+            else if (model == "keep")  cfg.collect = CollectModel::Keep;
+            else if (model == "piles") cfg.collect = CollectModel::Piles;
+            else return error("--collect must be sorted, keep or piles");
+        }
+
+        // ---- Time budget ----
+        else if (std::strcmp(argv[i], "--budget") == 0) {
+            if (i + 1 >= argc)
+                return error("--budget requires a number of seconds");
+            sawExperimentFlag = true;
+
+            double budget = std::stod(argv[++i]);
+            if (!(budget > 0) || budget > ExperimentRunner::TIME_BUDGET_MAX) {
+                return error("budget must be above 0 and at most " +
+                             std::to_string(static_cast<int>(ExperimentRunner::TIME_BUDGET_MAX)) + " seconds");
+            }
+            cfg.timeBudget = budget;
+        }
+        else if (std::strcmp(argv[i], "--time-costs") == 0) {
+            if (i + 1 >= argc)
+                return error("--time-costs requires a list, e.g. cut=2,riffle=4");
+            sawExperimentFlag = true;
+            sawTimeCosts = true;
+
+            // comma-separated name=seconds, unnamed shuffles keep their defaults
+            const std::string spec = argv[++i];
+            std::size_t start = 0;
+            while (start <= spec.size()) {
+                const std::size_t comma = std::min(spec.find(',', start), spec.size());
+                const std::string item = spec.substr(start, comma - start);
+                const auto eq = item.find('=');
+                if (eq == std::string::npos)
+                    return error("--time-costs expects name=seconds pairs, e.g. cut=2,riffle=4");
+
+                const std::string name = item.substr(0, eq);
+                Shuffle s;
+                if (name == "cut")           s = Shuffle::Cut;
+                else if (name == "riffle")   s = Shuffle::Riffle;
+                else if (name == "hindu")    s = Shuffle::Hindu;
+                else if (name == "overhand") s = Shuffle::Overhand;
+                else return error("--time-costs names must be cut, riffle, hindu or overhand");
+
+                double secs = std::stod(item.substr(eq + 1));
+                if (!(secs >= 0.01) || secs > ExperimentRunner::TIME_BUDGET_MAX) {
+                    return error("time costs must be between 0.01 and " +
+                                 std::to_string(static_cast<int>(ExperimentRunner::TIME_BUDGET_MAX)) + " seconds");
+                }
+                cfg.timeCost[static_cast<int>(s)] = secs;
+                start = comma + 1;
+            }
+        }
+
+        // ---- Beam search ----
+        else if (std::strcmp(argv[i], "--beam") == 0) {
+            if (i + 1 >= argc)
+                return error("--beam requires an integer value");
+            sawExperimentFlag = true;
+
+            int width = std::stoi(argv[++i]);
+            if (width < 1 || width > ExperimentRunner::BEAM_WIDTH_MAX) {
+                return error("beam width must be between 1 and " + std::to_string(ExperimentRunner::BEAM_WIDTH_MAX));
+            }
+            cfg.beamWidth = width;
+        }
+        else if (std::strcmp(argv[i], "--length") == 0) {
+            if (i + 1 >= argc)
+                return error("--length requires an integer value");
+            sawExperimentFlag = true;
+            sawLength = true;
+
+            int length = std::stoi(argv[++i]);
+            if (length < 1 || length > ExperimentRunner::SEARCH_K_MAX) {
+                return error("length must be between 1 and " + std::to_string(ExperimentRunner::SEARCH_K_MAX));
+            }
+            cfg.beamLength = length;
+        }
+
+        // ---- Card tracking ----
+        else if (std::strcmp(argv[i], "--exploit") == 0) {
+            if (i + 1 >= argc)
+                return error("--exploit requires a sequence, e.g. riffle,riffle,cut");
+            sawExperimentFlag = true;
+
+            const std::string spec = argv[++i];
+            cfg.exploitSequence.clear();
+            std::size_t start = 0;
+            while (start <= spec.size()) {
+                const std::size_t comma = std::min(spec.find(',', start), spec.size());
+                const std::string name = spec.substr(start, comma - start);
+                if (name == "cut")           cfg.exploitSequence.push_back(Shuffle::Cut);
+                else if (name == "riffle")   cfg.exploitSequence.push_back(Shuffle::Riffle);
+                else if (name == "hindu")    cfg.exploitSequence.push_back(Shuffle::Hindu);
+                else if (name == "overhand") cfg.exploitSequence.push_back(Shuffle::Overhand);
+                else return error("--exploit names must be cut, riffle, hindu or overhand");
+                start = comma + 1;
+            }
+            if (cfg.exploitSequence.size() > static_cast<std::size_t>(ExperimentRunner::SEARCH_K_MAX)) {
+                return error("--exploit sequences are at most " + std::to_string(ExperimentRunner::SEARCH_K_MAX) + " shuffles");
+            }
+        }
+        else if (std::strcmp(argv[i], "--track") == 0) {
+            if (i + 1 >= argc)
+                return error("--track requires an event, e.g. pos:Ks:47-51");
+            sawExperimentFlag = true;
+
+            ExperimentRunner::TrackEvent event;
+            std::string err;
+            if (!parse_track_event(argv[++i], event, err)) return error(err);
+            if (cfg.track.size() >= static_cast<std::size_t>(ExperimentRunner::TRACK_MAX)) {
+                return error("at most " + std::to_string(ExperimentRunner::TRACK_MAX) + " --track events");
+            }
+            cfg.track.push_back(event);
+        }
+        else if (std::strcmp(argv[i], "--exploit-trials") == 0) {
+            if (i + 1 >= argc)
+                return error("--exploit-trials requires an integer value");
+            sawExperimentFlag = true;
+            sawExploitTrials = true;
+
+            int trials = std::stoi(argv[++i]);
+            if (trials < 100 || trials > ExperimentRunner::EXPLOIT_TRIALS_MAX) {
+                return error("exploit trials must be between 100 and " + std::to_string(ExperimentRunner::EXPLOIT_TRIALS_MAX));
+            }
+            cfg.exploitTrials = trials;
+        }
+
+        else if (std::strcmp(argv[i], "--seed") == 0) {
+            if (i + 1 >= argc)
+                return error("--seed requires an integer value");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+            sawSeed = true;
+            cfg.seed = std::stoull(argv[++i]);
+        }
+
+        else if (std::strcmp(argv[i], "--bootstrap") == 0) {
+            if (i + 1 >= argc)
+                return error("--bootstrap requires an integer value");
+            sawExperimentFlag = true;
+
+            int reps = std::stoi(argv[++i]);
+            if (reps < 10 || reps > ExperimentRunner::BOOTSTRAP_MAX) {
+                return error("bootstrap replicates must be between 10 and " + std::to_string(ExperimentRunner::BOOTSTRAP_MAX));
+            }
+            cfg.bootstrap = reps;
+        }
+
+        // ---- Rankings ----
+        else if (std::strcmp(argv[i], "--weights") == 0) {
+            if (i + 1 >= argc)
+                return error("--weights requires a list, e.g. uniformity=1,adjacency=1");
+            sawRankingFlag = true;
+
+            // comma-separated name=weight, unnamed tests keep their default weight
+            ExperimentRunner::ScoreWeights weights;
+            const std::string spec = argv[++i];
+            std::size_t start = 0;
+            while (start <= spec.size()) {
+                const std::size_t comma = std::min(spec.find(',', start), spec.size());
+                const std::string item = spec.substr(start, comma - start);
+                const auto eq = item.find('=');
+                if (eq == std::string::npos)
+                    return error("--weights expects name=weight pairs, e.g. uniformity=1,adjacency=1");
+
+                const std::string name = item.substr(0, eq);
+                double* weight;
+                if (name == "uniformity")     weight = &weights.uniformity;
+                else if (name == "adjacency") weight = &weights.adjacency;
+                else if (name == "mixing")    weight = &weights.displacement;
+                else if (name == "poker")     weight = &weights.poker;
+                else return error("--weights names must be uniformity, adjacency, mixing or poker");
+
+                double w = std::stod(item.substr(eq + 1));
+                if (!(w >= 0) || w > 1000) {
+                    return error("weights must be between 0 and 1000");
+                }
+                *weight = w;
+                start = comma + 1;
+            }
+
+            // the first set scores the run, later ones are applied to its Pareto front
+            if (weightSets == 0) cfg.weights = weights;
+            else if (cfg.reweights.size() < ExperimentRunner::REWEIGHTS_MAX) cfg.reweights.push_back(weights);
+            else return error("--weights can be given at most " + std::to_string(ExperimentRunner::REWEIGHTS_MAX + 1) + " times");
+            ++weightSets;
+        }
+        else if (std::strcmp(argv[i], "--top") == 0) {
+            if (i + 1 >= argc)
+                return error("--top requires an integer value");
+            sawRankingFlag = true;
+
+            int top = std::stoi(argv[++i]);
+            if (top < 1 || top > ExperimentRunner::TOP_MAX) {
+                return error("top must be between 1 and " + std::to_string(ExperimentRunner::TOP_MAX));
+            }
+            cfg.top = top;
+        }
+
+        else if (std::strcmp(argv[i], "--share-prefixes") == 0) {
+            sawExperimentFlag = true;
+            cfg.sharePrefixes = true;
+        }
+
+        else if (std::strcmp(argv[i], "--stratify") == 0) {
+            sawExperimentFlag = true;
+            cfg.stratify = true;
+        }
+
+        else if (std::strcmp(argv[i], "--exact") == 0) {
+            if (i + 1 >= argc)
+                return error("--exact requires an integer value");
+            sawExperimentFlag = true;
+
+            int budget = std::stoi(argv[++i]);
+            if (budget < ExperimentRunner::EXACT_BUDGET_MIN || budget > ExperimentRunner::EXACT_BUDGET_MAX) {
+                return error("exact budget must be between " + std::to_string(ExperimentRunner::EXACT_BUDGET_MIN) +
+                             " and " + std::to_string(ExperimentRunner::EXACT_BUDGET_MAX));
+            }
+            cfg.exactBudget = budget;
+        }
+
+        // ---- Permutation pools ----
+        else if (std::strcmp(argv[i], "--pool") == 0) {
+            if (i + 1 >= argc)
+                return error("--pool requires an integer value");
+            sawExperimentFlag = true;
+
+            int size = std::stoi(argv[++i]);
+            if (size < 1 || size > ExperimentRunner::POOL_SIZE_MAX) {
+                return error("pool size must be between 1 and " + std::to_string(ExperimentRunner::POOL_SIZE_MAX));
+            }
+            cfg.poolSize = size;
+        }
+        else if (std::strcmp(argv[i], "--pool-file") == 0) {
+            if (i + 1 >= argc)
+                return error("--pool-file requires a file path");
+            sawExperimentFlag = true;
+            cfg.poolPath = argv[++i];
+        }
+
+        // ---- Sharding ----
+        else if (std::strcmp(argv[i], "--shard") == 0) {
+            if (i + 1 >= argc)
+                return error("--shard requires i/N");
+            sawExperimentFlag = true;
+            sawIdentityFlag = true;
+
+            const std::string spec = argv[++i];
+            const auto slash = spec.find('/');
+            if (slash == std::string::npos)
+                return error("--shard expects i/N, e.g. 0/4");
+
+            int index = std::stoi(spec.substr(0, slash));
+            int count = std::stoi(spec.substr(slash + 1));
+            if (count < 1 || index < 0 || index >= count) {
+                return error("shard index must be between 0 and N-1");
+            }
+
+            cfg.shardIndex = index;
+            cfg.shardCount = count;
+        }
+        else if (std::strcmp(argv[i], "--out") == 0) {
+            if (i + 1 >= argc)
+                return error("--out requires a file path");
+            sawExperimentFlag = true;
+            cfg.outPath = argv[++i];
+        }
+
+        else if (std::strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc)
+                return error("--threads requires an integer value");
+            sawPoolFlag = true;
+
+            int threads = std::stoi(argv[++i]);
+            if (threads < 0) {
+                return error("threads must be 0 (all cores) or more");
+            }
+            cfg.threads = threads;
+        }
+        else if (std::strcmp(argv[i], "--pipeline") == 0) {
+            if (i + 1 >= argc)
+                return error("--pipeline requires S:T");
+            sawExperimentFlag = true;
+
+            const std::string spec = argv[++i];
+            const auto colon = spec.find(':');
+            if (colon == std::string::npos)
+                return error("--pipeline expects S:T (shuffle:stats workers), e.g. 6:2");
+
+            int shuffleWorkers = std::stoi(spec.substr(0, colon));
+            int statsWorkers = std::stoi(spec.substr(colon + 1));
+            if (shuffleWorkers < 1 || statsWorkers < 1) {
+                return error("pipeline needs at least one shuffle and one stats worker");
+            }
+
+            cfg.pipelineShuffleWorkers = shuffleWorkers;
+            cfg.pipelineStatsWorkers = statsWorkers;
+        }
+
+        // ---- Profiling ----
+        else if (std::strcmp(argv[i], "--profile") == 0) {
+            if (!SHUFFLELAB_PROFILING)
+                return error("--profile is not available in this build (SHUFFLELAB_PROFILING=OFF)");
+            sawExperimentFlag = true;
+            cfg.profile = true;
+        }
+
+        // ---- Caching ----
+        else if (std::strcmp(argv[i], "--cache") == 0) {
+            if (i + 1 >= argc)
+                return error("--cache requires a file path");
+            sawPoolFlag = true;
+            cfg.cachePath = argv[++i];
+        }
+
+        // ---- Checkpointing ----
+        else if (std::strcmp(argv[i], "--checkpoint") == 0) {
+            if (i + 1 >= argc)
+                return error("--checkpoint requires a file path");
+            sawExperimentFlag = true;
+            cfg.checkpointPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--checkpoint-every") == 0) {
+            if (i + 1 >= argc)
+                return error("--checkpoint-every requires an integer value (seconds)");
+            sawExperimentFlag = true;
+
+            int secs = std::stoi(argv[++i]);
+            if (secs < 1) {
+                return error("checkpoint interval must be at least 1 second");
+            }
+            cfg.checkpointInterval = secs;
+        }
+        else if (std::strcmp(argv[i], "--resume") == 0) {
+            if (i + 1 >= argc)
+                return error("--resume requires a checkpoint file");
+            sawExperimentFlag = true;
+            resumePath = argv[++i];
+        }
 
         // ---- Unknown ----
         else {
@@ -107,18 +579,155 @@ int main(int argc, char** argv) {
     }
 
     // ----- Enforce mode exclusivity -----
-    if ((wantHelp + wantDesc + wantRun) > 1) {
-        return error("choose only one of --run, --help, or --desc");
+    if ((wantHelp + wantDesc + wantRun + wantMerge + wantCalibrate + wantManifest + wantServe) > 1) {
+        return error("choose only one of --run, --merge, --calibrate, --manifest, --serve, --help, or --desc");
+    }
+
+    if ((wantHelp || wantDesc || wantMerge || wantCalibrate || wantManifest) && (sawExperimentFlag || sawPoolFlag)) {
+        return error("--help, --desc, --merge, --calibrate and --manifest cannot be combined with experiment flags");
+    }
+
+    if (wantServe && sawExperimentFlag) {
+        return error("--serve takes experiment settings per request; only --threads and --cache apply to it");
+    }
+
+    if (wantCalibrate && calibrationPaths.empty()) {
+        return error("--calibrate requires one or more recorded shuffle files");
+    }
+
+    if (wantMerge && mergePaths.empty()) {
+        return error("--merge requires one or more shard result files");
+    }
+
+    if (cfg.shardCount > 1 && cfg.outPath.empty()) {
+        return error("--shard requires --out <file> for the partial results");
+    }
+
+    bool tracksSeat = false;
+    for (const auto& e : cfg.track) {
+        if (e.kind != ExperimentRunner::TrackEvent::Kind::Seat) continue;
+        tracksSeat = true;
+        if (e.lo >= cfg.pokerSeats) {
+            return error("--track seat " + std::to_string(e.lo + 1) + " is past the " + std::to_string(cfg.pokerSeats) +
+                         " seats dealt (set --seats)");
+        }
+    }
+
+    if (sawSeats && !cfg.testPoker && cfg.streamHands == 0 && !tracksSeat) {
+        return error("--seats only applies with --poker, --stream or a --track seat event");
+    }
+
+    if ((!cfg.track.empty() || sawExploitTrials) && cfg.exploitSequence.empty()) {
+        return error("--track and --exploit-trials require --exploit <sequence>");
+    }
+
+    if (!cfg.exploitSequence.empty() && cfg.track.empty()) {
+        return error("--exploit requires one or more --track events");
+    }
+
+    if (!cfg.exploitSequence.empty() && (sawK || sawTrials || sawTestToggle || cfg.timeBudget > 0 || cfg.beamWidth > 0 ||
+                                         cfg.shardCount > 1 || !cfg.outPath.empty() || !cfg.checkpointPath.empty() ||
+                                         !resumePath.empty() || !cfg.cachePath.empty() || cfg.streamHands > 0 ||
+                                         cfg.pipelineShuffleWorkers > 0 || cfg.bootstrap > 0 || cfg.sharePrefixes ||
+                                         sawRankingFlag)) {
+        return error("--exploit tracks one given sequence; it cannot be combined with --k, --trials, test toggles, "
+                     "--budget, --beam, --shard, --out, --checkpoint, --resume, --cache, --stream, --pipeline, "
+                     "--bootstrap, --share-prefixes, --weights or --top");
+    }
+
+    if (sawCycleOption && cfg.streamHands == 0) {
+        return error("--warmup and --collect require --stream <hands>");
+    }
+
+    if (cfg.streamHands > 0 && cfg.pipelineShuffleWorkers > 0) {
+        return error("--pipeline does not support --stream yet");
+    }
+
+    if (sawTimeCosts && cfg.timeBudget == 0) {
+        return error("--time-costs requires --budget <seconds>");
+    }
+
+    if (cfg.timeBudget > 0 && (sawK || cfg.shardCount > 1 || !cfg.outPath.empty() || !cfg.checkpointPath.empty() ||
+                               !resumePath.empty() || !cfg.cachePath.empty() || cfg.streamHands > 0 ||
+                               cfg.pipelineShuffleWorkers > 0)) {
+        return error("--budget searches sequence lengths itself and cannot be combined with --k, --shard, --out, "
+                     "--checkpoint, --resume, --cache, --stream or --pipeline");
+    }
+
+    if (sawLength && cfg.beamWidth == 0) {
+        return error("--length requires --beam <width>");
+    }
+
+    if (cfg.beamWidth > 0 && (cfg.timeBudget > 0 || sawK || cfg.shardCount > 1 || !cfg.outPath.empty() ||
+                              !cfg.checkpointPath.empty() || !resumePath.empty() || !cfg.cachePath.empty() ||
+                              cfg.streamHands > 0 || cfg.pipelineShuffleWorkers > 0)) {
+        return error("--beam cannot be combined with --budget, --k, --shard, --out, --checkpoint, --resume, "
+                     "--cache, --stream or --pipeline");
+    }
+
+    if (cfg.bootstrap > 0 && (cfg.timeBudget > 0 || cfg.beamWidth > 0 || cfg.shardCount > 1 || !cfg.outPath.empty() ||
+                              !cfg.checkpointPath.empty() || !resumePath.empty() || !cfg.cachePath.empty() ||
+                              cfg.streamHands > 0 || cfg.pipelineShuffleWorkers > 0)) {
+        return error("--bootstrap needs every sequence simulated in this run; it cannot be combined with --budget, "
+                     "--beam, --shard, --out, --checkpoint, --resume, --cache, --stream or --pipeline");
+    }
+
+    if (!cfg.poolPath.empty() && cfg.poolSize == 0) {
+        return error("--pool-file requires --pool <size>");
+    }
+
+    if (cfg.poolSize > 0 && (!cfg.exploitSequence.empty() || cfg.shardCount > 1 || !cfg.outPath.empty() ||
+                             !cfg.checkpointPath.empty() || !resumePath.empty())) {
+        return error("--pool approximates the shuffles of this run only; it cannot be combined with --exploit, "
+                     "--shard, --out, --checkpoint or --resume");
+    }
+
+    if (cfg.stratify && (!cfg.exploitSequence.empty() || cfg.timeBudget > 0 || cfg.beamWidth > 0 || cfg.shardCount > 1 ||
+                         !cfg.outPath.empty() || !cfg.checkpointPath.empty() || !resumePath.empty() ||
+                         cfg.streamHands > 0 || cfg.pipelineShuffleWorkers > 0 || cfg.bootstrap > 0 ||
+                         cfg.sharePrefixes || cfg.poolSize > 0)) {
+        return error("--stratify applies to a plain sweep's independent trials; it cannot be combined with --exploit, "
+                     "--budget, --beam, --shard, --out, --checkpoint, --resume, --stream, --pipeline, --bootstrap, "
+                     "--share-prefixes or --pool");
+    }
+
+    if (cfg.exactBudget > 0 && (!cfg.exploitSequence.empty() || cfg.timeBudget > 0 || cfg.beamWidth > 0 || cfg.shardCount > 1 ||
+                                !cfg.outPath.empty() || !cfg.checkpointPath.empty() || !resumePath.empty() ||
+                                cfg.streamHands > 0 || cfg.pipelineShuffleWorkers > 0 || cfg.bootstrap > 0 ||
+                                cfg.sharePrefixes || cfg.poolSize > 0 || cfg.stratify)) {
+        return error("--exact applies to a plain sweep's trials; it cannot be combined with --exploit, --budget, "
+                     "--beam, --shard, --out, --checkpoint, --resume, --stream, --pipeline, --bootstrap, "
+                     "--share-prefixes, --pool or --stratify");
     }
 
-    if ((wantHelp || wantDesc) && sawExperimentFlag) {
-        return error("--help and --desc cannot be combined with experiment flags");
+    if (cfg.sharePrefixes && (cfg.timeBudget > 0 || cfg.beamWidth > 0 || cfg.shardCount > 1 || !cfg.outPath.empty() ||
+                              !cfg.checkpointPath.empty() || !resumePath.empty() || cfg.streamHands > 0 ||
+                              cfg.pipelineShuffleWorkers > 0 || cfg.bootstrap > 0)) {
+        return error("--share-prefixes cannot be combined with --budget, --beam, --shard, --out, --checkpoint, "
+                     "--resume, --stream, --pipeline or --bootstrap");
     }
 
     if (!wantRun && sawExperimentFlag) {
         return error("experiment flags require --run");
     }
 
+    if (!wantRun && !wantServe && sawPoolFlag) {
+        return error("--threads and --cache require --run or --serve");
+    }
+
+    if (sawRankingFlag && !wantRun && !wantMerge) {
+        return error("--weights and --top require --run or --merge");
+    }
+
+    // --merge checks against the shards' tests once they are read, --resume takes the checkpoint's
+    if (wantRun && resumePath.empty() && !ExperimentRunner::weights_valid(cfg)) {
+        return error("--weights must give an enabled test a weight above 0");
+    }
+
+    if ((cfg.top > 0 || !cfg.reweights.empty()) && (cfg.timeBudget > 0 || cfg.beamWidth > 0)) {
+        return error("--top and repeated --weights rank a sweep; they cannot be combined with --budget or --beam");
+    }
+
     // ----- Dispatch -----
     if (wantHelp) {
         print_help();
@@ -130,6 +739,41 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (wantMerge) {
+        std::string err;
+        ExperimentRunner runner(cfg);
+        if (!runner.merge(mergePaths, err)) return error(err);
+        return 0;
+    }
+
+    if (wantManifest) {
+        Manifest manifest;
+        std::string err;
+        if (!load_manifest(manifestPath, manifest, err)) return error(err);
+        print_manifest(manifest, run_manifest(manifest));
+        return 0;
+    }
+
+    if (wantServe) {
+        ServerOptions options;
+        options.socketPath = socketPath;
+        options.threads = cfg.threads;
+        options.cachePath = cfg.cachePath;
+        std::string err;
+        if (!serve(options, err)) return error(err);
+        return 0;
+    }
+
+    if (wantCalibrate) {
+        CalibrationData data;
+        std::string err;
+        for (const std::string& path : calibrationPaths) {
+            if (!load_calibration_data(path, data, err)) return error(err);
+        }
+        print_calibration(data, calibrate(data, 0, 0), calibrationPaths.size()); // fixed seed: repeatable fits
+        return 0;
+    }
+
     if (!wantRun) {
         print_logo();
         std::cout << "Card shuffle analysis tool\n";
@@ -139,10 +783,51 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    // ----- Resume -----
+    Checkpoint checkpoint;
+    if (!resumePath.empty()) {
+        if (sawIdentityFlag || sawRankingFlag) {
+            return error("--resume restores k, trials, tests, seed, shard, weights and top from the checkpoint; do not pass them");
+        }
+        if (!load_checkpoint(resumePath, checkpoint)) {
+            return error("could not read checkpoint " + resumePath);
+        }
+        // results are only kept by runs that started with --out, so the file cannot change
+        if (!cfg.outPath.empty() && cfg.outPath != checkpoint.cfg.outPath) {
+            return error(checkpoint.cfg.outPath.empty()
+                             ? "the checkpointed run kept no results; --out cannot be added on --resume"
+                             : "--resume writes results to the checkpoint's --out file " + checkpoint.cfg.outPath);
+        }
+
+        cfg.kMax           = checkpoint.cfg.kMax;
+        cfg.trials         = checkpoint.cfg.trials;
+        cfg.testUniformity = checkpoint.cfg.testUniformity;
+        cfg.testAdjacency  = checkpoint.cfg.testAdjacency;
+        cfg.testMixing     = checkpoint.cfg.testMixing;
+        cfg.testPoker      = checkpoint.cfg.testPoker;
+        cfg.pokerSeats     = checkpoint.cfg.pokerSeats;
+        cfg.streamHands    = checkpoint.cfg.streamHands;
+        cfg.streamWarmup   = checkpoint.cfg.streamWarmup;
+        cfg.collect        = checkpoint.cfg.collect;
+        cfg.seed           = checkpoint.cfg.seed;
+        cfg.shardIndex     = checkpoint.cfg.shardIndex;
+        cfg.shardCount     = checkpoint.cfg.shardCount;
+        cfg.weights        = checkpoint.cfg.weights;
+        cfg.reweights      = checkpoint.cfg.reweights;
+        cfg.top            = checkpoint.cfg.top;
+        cfg.outPath        = checkpoint.cfg.outPath;
+
+        if (cfg.checkpointPath.empty()) cfg.checkpointPath = resumePath; // keep checkpointing in place
+    }
+    else if (!sawSeed) {
+        std::random_device rd;
+        cfg.seed = (static_cast<uint64_t>(rd()) << 32) | rd(); // reported so the run can be repeated
+    }
+
     // ----- Run experiment -----
     // print_logo();
     ExperimentRunner runner(cfg);
-    runner.run();
+    runner.run(resumePath.empty() ? nullptr : &checkpoint);
 
     return 0;
 }
@@ -0,0 +1,114 @@
+#include "BinaryIO.h"
+#include "Deck.h"
+
+#include <unistd.h> // fsync
+
+void put_experiment(BinaryWriter& w, const ExperimentRunner::ExperimentConfig& cfg) {
+    w.put<int32_t>(cfg.kMax);
+    w.put<int32_t>(cfg.trials);
+    w.put<uint8_t>(cfg.testUniformity);
+    w.put<uint8_t>(cfg.testAdjacency);
+    w.put<uint8_t>(cfg.testMixing);
+    w.put<uint8_t>(cfg.testPoker);
+    w.put<int32_t>(cfg.pokerSeats);
+    w.put<int32_t>(cfg.streamHands);
+    w.put<int32_t>(cfg.streamWarmup);
+    w.put<int32_t>(static_cast<int32_t>(cfg.collect));
+    w.put<uint64_t>(cfg.seed);
+    w.put<int32_t>(cfg.shardIndex);
+    w.put<int32_t>(cfg.shardCount);
+}
+
+void get_experiment(BinaryReader& r, ExperimentRunner::ExperimentConfig& cfg) {
+    int32_t kMax = 0, trials = 0, seats = 0, hands = 0, warmup = 0, collect = 0, shardIndex = 0, shardCount = 0;
+    uint8_t uni = 0, adj = 0, mix = 0, poker = 0;
+    r.get(kMax);
+    r.get(trials);
+    r.get(uni);
+    r.get(adj);
+    r.get(mix);
+    r.get(poker);
+    r.get(seats);
+    r.get(hands);
+    r.get(warmup);
+    r.get(collect);
+    r.get(cfg.seed);
+    r.get(shardIndex);
+    r.get(shardCount);
+
+    cfg.kMax = kMax;
+    cfg.trials = trials;
+    cfg.testUniformity = uni;
+    cfg.testAdjacency = adj;
+    cfg.testMixing = mix;
+    cfg.testPoker = poker;
+    cfg.pokerSeats = seats;
+    cfg.streamHands = hands;
+    cfg.streamWarmup = warmup;
+    cfg.collect = static_cast<CollectModel>(collect);
+    cfg.shardIndex = shardIndex;
+    cfg.shardCount = shardCount;
+
+    if (r.ok && (shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount)) r.ok = false;
+    if (r.ok && (seats < 2 || seats > POKER_MAX_SEATS)) r.ok = false;
+    if (r.ok && (collect < 0 || collect > static_cast<int32_t>(CollectModel::Piles))) r.ok = false;
+}
+
+bool write_file_atomic(const std::string& path, const std::function<void(BinaryWriter&)>& body) {
+    const std::string tmp = path + ".tmp";
+
+    BinaryWriter w;
+    w.f = std::fopen(tmp.c_str(), "wb");
+    if (!w.f) return false;
+
+    body(w);
+
+    w.ok = w.ok && std::fflush(w.f) == 0;
+    w.ok = w.ok && fsync(fileno(w.f)) == 0;
+    w.ok = (std::fclose(w.f) == 0) && w.ok;
+
+    if (!w.ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool read_file(const std::string& path, const std::function<void(BinaryReader&)>& body) {
+    BinaryReader r;
+    r.f = std::fopen(path.c_str(), "rb");
+    if (!r.f) return false;
+
+    body(r);
+
+    std::fclose(r.f);
+    return r.ok;
+}
+
+void put_context(BinaryWriter& w, const DeckContext& ctx) {
+    w.put(ctx.deck);
+    w.put(ctx.numShuffles);
+    w.put(ctx.rng.get_state());
+    w.put(ctx.rng.get_increment());
+    w.put(ctx.posFreq);
+    w.put(ctx.adjFreq);
+    w.put(ctx.dispHist);
+    w.put(ctx.pokerClassFreq);
+    w.put(ctx.pokerEquity);
+    w.put(ctx.pokerDeals);
+}
+
+void get_context(BinaryReader& r, DeckContext& ctx) {
+    uint64_t state = 0, inc = 0;
+    r.get(ctx.deck);
+    r.get(ctx.numShuffles);
+    r.get(state);
+    r.get(inc);
+    r.get(ctx.posFreq);
+    r.get(ctx.adjFreq);
+    r.get(ctx.dispHist);
+    r.get(ctx.pokerClassFreq);
+    r.get(ctx.pokerEquity);
+    r.get(ctx.pokerDeals);
+    ctx.rng.set_state(state, inc);
+}
@@ -0,0 +1,129 @@
+#include "ExperimentRunner.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ===== Bootstrap =====
+
+// A sequence's trials are independent, so resampling them with replacement shows how far
+// its score could move on another run of the same size. Each trial is kept as a compact
+// record - the final deck, from which every statistic but the Hold'em deal is re-derived,
+// and the packed deal - and each replicate rebuilds the accumulators from the records.
+
+namespace {
+
+struct TrialRecord {
+    Deck deck;
+    PokerDeal deal;
+};
+
+constexpr uint64_t BOOTSTRAP_SEED_MIX = 0x9E3779B97F4A7C15ull; // resampling stream != trial stream
+
+} // namespace
+
+// evaluate_sequence (same trials, same result), plus cfg.bootstrap replicate scores.
+// ctx is scratch afterwards - it holds the last replicate.
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_bootstrap(DeckContext& ctx, const std::vector<int>& idx, float* replicates) {
+    ctx.rng.seed(cfg.seed, sequence_code(idx));
+
+    std::vector<TrialRecord> records(cfg.trials);
+    for (int t = 0; t < cfg.trials; ++t) {
+        shuffle_trial(ctx, idx);
+        observe_trial(ctx);
+        records[t].deck = ctx.deck;
+        if (cfg.testPoker) records[t].deal = ctx.deal_poker(cfg.pokerSeats);
+    }
+
+    const SequenceResult point = summarise(ctx);
+    const int shuffles = ctx.numShuffles;
+
+    std::vector<SequenceResult> reps(cfg.bootstrap);
+    ctx.rng.seed(cfg.seed ^ BOOTSTRAP_SEED_MIX, sequence_code(idx));
+    for (int b = 0; b < cfg.bootstrap; ++b) {
+        ctx.posFreq = {};
+        ctx.adjFreq = {};
+        ctx.dispHist = {};
+        ctx.pokerClassFreq = {};
+        ctx.pokerEquity = {};
+        ctx.pokerDeals = 0;
+
+        for (int t = 0; t < cfg.trials; ++t) {
+            const TrialRecord& rec = records[ctx.rng.random_bounded(cfg.trials)];
+            ctx.deck = rec.deck;
+            if (cfg.testAdjacency)  ctx.observe_adjacency();
+            if (cfg.testUniformity) ctx.observe_uniformity();
+            if (cfg.testMixing)     ctx.observe_displacement();
+            if (cfg.testPoker)      ctx.add_poker_deal(rec.deal, cfg.pokerSeats);
+        }
+        ctx.numShuffles = shuffles;
+
+        reps[b] = summarise(ctx);
+    }
+
+    // Repeated trials in a resample add their own noise, so every χ² statistic comes out
+    // high on average. Each statistic is shifted back by its bootstrap bias before scoring
+    // (scoring raw replicates gives intervals that miss the point estimate entirely).
+    auto bias = [&](double SequenceResult::*field) {
+        if (point.*field == -1) return 0.0; // test disabled
+        double sum = 0;
+        for (const SequenceResult& r : reps) sum += r.*field;
+        return sum / reps.size() - point.*field;
+    };
+    const double biasU = bias(&SequenceResult::uniformity), biasA = bias(&SequenceResult::adjacency);
+    const double biasD = bias(&SequenceResult::displacement), biasP = bias(&SequenceResult::poker);
+
+    for (int b = 0; b < cfg.bootstrap; ++b) {
+        const SequenceResult& r = reps[b];
+        replicates[b] = static_cast<float>(score(r.uniformity == -1 ? -1 : r.uniformity - biasU,
+                                                 r.adjacency == -1 ? -1 : r.adjacency - biasA,
+                                                 r.displacement == -1 ? -1 : r.displacement - biasD,
+                                                 r.poker == -1 ? -1 : r.poker - biasP));
+    }
+
+    return point;
+}
+
+// Percentile intervals per sequence, and how often each sequence is the best of its
+// replicate column. Sequences are simulated independently, so replicate b of every
+// sequence together is one draw of the whole ranking.
+void ExperimentRunner::summarise_bootstrap(ThreadPool& pool, const std::vector<float>& replicates, std::vector<BootstrapResult>& results) {
+    const std::size_t n = results.size();
+    const int B = cfg.bootstrap;
+    const std::size_t lowIdx = static_cast<std::size_t>(std::floor(0.025 * (B - 1)));
+    const std::size_t highIdx = static_cast<std::size_t>(std::ceil(0.975 * (B - 1)));
+
+    pool.parallel_for(n, [&](std::size_t s) {
+        std::vector<float> sorted(replicates.begin() + s * B, replicates.begin() + (s + 1) * B);
+        std::sort(sorted.begin(), sorted.end());
+        results[s].low = sorted[lowIdx];
+        results[s].high = sorted[highIdx];
+    });
+
+    // Best per replicate within contiguous chunks of sequences (row-wise reads), then
+    // reduced in chunk order - ties go to the lower rank, as in the sweep
+    const std::size_t chunks = std::min<std::size_t>(n, static_cast<std::size_t>(pool.size()) * 4);
+    std::vector<std::size_t> winner(chunks * B);
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        const std::size_t begin = n * c / chunks, end = n * (c + 1) / chunks;
+        std::vector<float> best(B, std::numeric_limits<float>::infinity());
+        std::size_t* win = &winner[c * B];
+        std::fill(win, win + B, begin);
+        for (std::size_t s = begin; s < end; ++s) {
+            const float* row = &replicates[s * B];
+            for (int b = 0; b < B; ++b) {
+                if (row[b] < best[b]) { best[b] = row[b]; win[b] = s; }
+            }
+        }
+    });
+
+    for (int b = 0; b < B; ++b) {
+        std::size_t best = winner[b];
+        for (std::size_t c = 1; c < chunks; ++c) {
+            const std::size_t s = winner[c * B + b];
+            if (replicates[s * B + b] < replicates[best * B + b]) best = s;
+        }
+        results[best].pFirst += 1.0 / B;
+    }
+}
@@ -0,0 +1,401 @@
+#include "Calibration.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+
+// ===== Model Calibration =====
+
+namespace {
+
+constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
+
+constexpr int SIM_REPS = 20;   // simulated shuffles per recorded deck and candidate
+constexpr int SIM_ROUNDS = 6;  // coordinate sweeps over every free table parameter
+
+// Spreads tried by both fits: geometric ladder from 0.25 to ~40 cards
+std::vector<double> spread_ladder(double step) {
+    std::vector<double> spreads;
+    for (double s = 0.25; s <= 40; s *= step) spreads.push_back(s);
+    return spreads;
+}
+
+// Drop tables give a count - a zero drop would never finish a packet
+int min_value(ModelTable t) {
+    return (t == ModelTable::HinduDrop || t == ModelTable::OverhandDrop) ? 1 : 0;
+}
+
+// Some Gaussian weight must survive in [min, max), or create_cdf divides by zero
+bool valid_params(const CdfParams& p, ModelTable t) {
+    if (p.min < min_value(t) || p.max > DECK_SIZE || p.max <= p.min || !(p.spread > 0)) return false;
+    const double d = std::clamp(p.centre, p.min, p.max - 1) - p.centre;
+    return d * d / (2 * p.spread * p.spread) < 50;
+}
+
+// log P(draw = k) for the table create_cdf builds (integer weights, as sampled)
+std::array<double, DECK_SIZE> log_probs(const CdfTable& cdf) {
+    std::array<double, DECK_SIZE> lp;
+    const double total = cdf[DECK_SIZE - 1];
+    uint16_t prev = 0;
+    for (int k = 0; k < DECK_SIZE; ++k) {
+        const int w = cdf[k] - prev;
+        lp[k] = (w > 0 && total > 0) ? std::log(w / total) : NEG_INF;
+        prev = cdf[k];
+    }
+    return lp;
+}
+
+bool parse_deck(std::istringstream& in, Deck& deck) {
+    std::array<bool, DECK_SIZE> seen{};
+    for (int i = 0; i < DECK_SIZE; ++i) {
+        int card = -1;
+        if (!(in >> card) || card < 0 || card >= DECK_SIZE || seen[card]) return false;
+        seen[card] = true;
+        deck[i] = static_cast<Card>(card);
+    }
+    return true;
+}
+
+// ---- Likelihood ----
+
+// What the data says about one table's draws
+struct Evidence {
+    std::array<int, DECK_SIZE> counts{}; // draws seen directly
+    int draws = 0;
+    std::vector<std::vector<std::pair<int, double>>> mixtures; // per record: possible draws, log weight
+
+    int records() const { return draws + static_cast<int>(mixtures.size()); }
+};
+
+double log_likelihood(const Evidence& ev, const std::array<double, DECK_SIZE>& lp) {
+    double ll = 0;
+    for (int k = 0; k < DECK_SIZE; ++k) {
+        if (ev.counts[k] == 0) continue;
+        if (lp[k] == NEG_INF) return NEG_INF;
+        ll += ev.counts[k] * lp[k];
+    }
+    for (const auto& mix : ev.mixtures) { // log Σ P(k) w_k
+        double top = NEG_INF;
+        for (const auto& [k, lw] : mix) top = std::max(top, lp[k] + lw);
+        if (top == NEG_INF) return NEG_INF;
+        double sum = 0;
+        for (const auto& [k, lw] : mix) sum += std::exp(lp[k] + lw - top);
+        ll += top + std::log(sum);
+    }
+    return ll;
+}
+
+// Support is the tightest range holding every record (any wider range only lowers the
+// likelihood of what was seen); centre and spread by exhaustive search over a grid
+TableFit fit_likelihood(ModelTable table, const Evidence& ev) {
+    TableFit fit;
+    fit.table = table;
+    fit.params = default_params(table);
+    fit.records = ev.records();
+    if (fit.records == 0) return fit;
+
+    int lo = DECK_SIZE, hi = -1;
+    for (int k = 0; k < DECK_SIZE; ++k) {
+        if (ev.counts[k] > 0) { lo = std::min(lo, k); hi = std::max(hi, k); }
+    }
+    for (const auto& mix : ev.mixtures) {
+        bool covered = false;
+        int nearest = mix.front().first;
+        const int target = lo <= hi ? lo : fit.params.centre;
+        for (const auto& [k, lw] : mix) {
+            covered = covered || (k >= lo && k <= hi);
+            if (std::abs(k - target) < std::abs(nearest - target)) nearest = k;
+        }
+        if (!covered) { lo = std::min(lo, nearest); hi = std::max(hi, nearest); }
+    }
+    lo = std::max(lo, min_value(table));
+
+    double best = NEG_INF;
+    for (int centre = 0; centre < DECK_SIZE; ++centre) {
+        for (double spread : spread_ladder(1.05)) {
+            const CdfParams p{lo, hi + 1, centre, spread};
+            if (!valid_params(p, table)) continue;
+            const double ll = log_likelihood(ev, log_probs(create_cdf(p.min, p.max, p.centre, p.spread)));
+            if (ll > best) {
+                best = ll;
+                fit.params = p;
+                fit.method = TableFit::Method::Likelihood;
+            }
+        }
+    }
+    fit.objective = best / fit.records;
+    return fit;
+}
+
+// Split points c for which after interleaves before[0, c) and before[c, 52) (GSR riffle,
+// every interleave of a split equally likely); empty if after is no riffle of before
+std::vector<int> riffle_splits(const Deck& before, const Deck& after) {
+    std::array<int, DECK_SIZE> pos;
+    for (int i = 0; i < DECK_SIZE; ++i) pos[after[i]] = i;
+
+    int descents = 0, at = 0;
+    for (int i = 0; i + 1 < DECK_SIZE; ++i) {
+        if (pos[before[i]] > pos[before[i + 1]]) { ++descents; at = i + 1; }
+    }
+
+    std::vector<int> splits;
+    if (descents == 1) splits.push_back(at);
+    if (descents == 0) {
+        for (int c = 0; c < DECK_SIZE; ++c) splits.push_back(c);
+    }
+    return splits;
+}
+
+double log_choose(int n, int k) {
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+// ---- Simulation ----
+
+// Summary of one shuffle: original neighbours kept, untouched cards at the bottom and
+// where the new top card came from - one histogram block each
+constexpr int STAT_BLOCK = DECK_SIZE + 1;
+using StatHist = std::array<double, 3 * STAT_BLOCK>;
+
+void add_stats(const Deck& before, const Deck& after, StatHist& hist) {
+    std::array<int, DECK_SIZE> pos, from;
+    for (int i = 0; i < DECK_SIZE; ++i) {
+        pos[after[i]] = i;
+        from[before[i]] = i;
+    }
+
+    int kept = 0;
+    for (int i = 0; i + 1 < DECK_SIZE; ++i) kept += (pos[before[i + 1]] == pos[before[i]] + 1);
+
+    int untouched = 0;
+    while (untouched < DECK_SIZE && after[DECK_SIZE - 1 - untouched] == before[DECK_SIZE - 1 - untouched]) ++untouched;
+
+    ++hist[kept];
+    ++hist[STAT_BLOCK + untouched];
+    ++hist[2 * STAT_BLOCK + from[after[0]]];
+}
+
+// Two-sample χ² between histograms of nObs and nSim shuffles
+double distance(const StatHist& obs, double nObs, const StatHist& sim, double nSim) {
+    const double a = std::sqrt(nSim / nObs), b = std::sqrt(nObs / nSim);
+    double chiSq = 0;
+    for (std::size_t i = 0; i < obs.size(); ++i) {
+        if (obs[i] + sim[i] == 0) continue;
+        const double d = obs[i] * a - sim[i] * b;
+        chiSq += d * d / (obs[i] + sim[i]);
+    }
+    return chiSq;
+}
+
+// Tables are built once per distinct parameter set and shared by every candidate model
+class TableCache {
+public:
+    const CdfTable* get(const CdfParams& p) {
+        auto& slot = tables[{p.min, p.max, p.centre, p.spread}];
+        if (!slot) slot = std::make_unique<CdfTable>(create_cdf(p.min, p.max, p.centre, p.spread));
+        return slot.get();
+    }
+    std::size_t size() const { return tables.size(); }
+
+private:
+    std::map<std::tuple<int, int, int, double>, std::unique_ptr<CdfTable>> tables;
+};
+
+} // namespace
+
+bool load_calibration_data(const std::string& path, CalibrationData& data, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "could not read calibration file " + path;
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    auto fail = [&](const std::string& msg) {
+        err = path + ":" + std::to_string(lineNo) + ": " + msg;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = line.substr(0, line.find('#'));
+        std::istringstream ss(line);
+        std::string name, extra;
+        if (!(ss >> name)) continue;
+
+        if (line.find('|') != std::string::npos) {
+            Shuffle s;
+            if (name == "cut")           s = Shuffle::Cut;
+            else if (name == "riffle")   s = Shuffle::Riffle;
+            else if (name == "hindu")    s = Shuffle::Hindu;
+            else if (name == "overhand") s = Shuffle::Overhand;
+            else return fail("unknown shuffle '" + name + "' (cut, riffle, hindu or overhand)");
+
+            Deck before, after;
+            std::string bar;
+            if (!parse_deck(ss, before) || !(ss >> bar) || bar != "|" || !parse_deck(ss, after) || (ss >> extra)) {
+                return fail("expected <shuffle> <52 cards> | <52 cards>, each an order of cards 0-51");
+            }
+            data.decks[static_cast<int>(s)].push_back({before, after});
+        } else {
+            int t = 0;
+            while (t < MODEL_TABLES && to_string(static_cast<ModelTable>(t)) != name) ++t;
+            if (t == MODEL_TABLES) {
+                return fail("unknown table '" + name + "' (cut, riffle, hindu_ops, hindu_cut, hindu_drop, "
+                            "overhand_cut or overhand_drop)");
+            }
+
+            int value = -1;
+            const int lowest = min_value(static_cast<ModelTable>(t));
+            if (!(ss >> value) || value < lowest || value >= DECK_SIZE || (ss >> extra)) {
+                return fail("expected <table> <value " + std::to_string(lowest) + "-51>");
+            }
+            data.samples[t].push_back(value);
+        }
+        ++data.records;
+    }
+    return true;
+}
+
+CalibrationOutcome calibrate(const CalibrationData& data, int threads, uint64_t seed) {
+    CalibrationOutcome out;
+
+    // Tables whose draws the data shows, directly or up to a known set: maximum likelihood
+    std::array<Evidence, MODEL_TABLES> evidence;
+    for (int t = 0; t < MODEL_TABLES; ++t) {
+        for (int v : data.samples[t]) {
+            ++evidence[t].counts[v];
+            ++evidence[t].draws;
+        }
+    }
+
+    Evidence& cuts = evidence[static_cast<int>(ModelTable::Cut)];
+    for (const auto& [before, after] : data.decks[static_cast<int>(Shuffle::Cut)]) {
+        int c = 0;
+        while (before[c] != after[0]) ++c;
+        bool rotation = true;
+        for (int i = 0; i < DECK_SIZE; ++i) rotation = rotation && after[i] == before[(c + i) % DECK_SIZE];
+        if (!rotation) { ++out.rejected; continue; }
+        ++cuts.counts[c];
+        ++cuts.draws;
+    }
+
+    Evidence& splits = evidence[static_cast<int>(ModelTable::Riffle)];
+    for (const auto& [before, after] : data.decks[static_cast<int>(Shuffle::Riffle)]) {
+        const std::vector<int> cs = riffle_splits(before, after);
+        if (cs.empty()) { ++out.rejected; continue; }
+        std::vector<std::pair<int, double>> mix;
+        for (int c : cs) mix.push_back({c, -log_choose(DECK_SIZE, c)});
+        splits.mixtures.push_back(std::move(mix));
+    }
+
+    for (int t = 0; t < MODEL_TABLES; ++t) {
+        out.fits[t] = fit_likelihood(static_cast<ModelTable>(t), evidence[t]);
+    }
+
+    // Hindu and overhand deck orders: many draws per shuffle, no tractable likelihood.
+    // Coordinate search over the parameters of every table without direct evidence,
+    // scoring each candidate by simulating the recorded decks (common random numbers,
+    // so candidates differ only by their parameters) against the recorded outcome.
+    ThreadPool pool(threads);
+    TableCache cache;
+
+    ShuffleModel model;
+    for (int t = 0; t < MODEL_TABLES; ++t) model.tables[t] = cache.get(out.fits[t].params);
+
+    const std::pair<Shuffle, std::vector<ModelTable>> simulated[] = {
+        {Shuffle::Hindu, {ModelTable::HinduOps, ModelTable::HinduCut, ModelTable::HinduDrop}},
+        {Shuffle::Overhand, {ModelTable::OverhandCut, ModelTable::OverhandDrop}},
+    };
+
+    for (const auto& [shuffle, tables] : simulated) {
+        const auto& records = data.decks[static_cast<int>(shuffle)];
+        if (records.empty()) continue;
+
+        std::vector<ModelTable> free;
+        for (ModelTable t : tables) {
+            if (out.fits[static_cast<int>(t)].method == TableFit::Method::Default) free.push_back(t);
+        }
+        if (free.empty()) continue;
+
+        StatHist observed{};
+        for (const auto& [before, after] : records) add_stats(before, after, observed);
+        const double nObs = records.size(), nSim = nObs * SIM_REPS;
+
+        auto simulate = [&](const ShuffleModel& candidate) {
+            DeckContext ctx;
+            ctx.model = &candidate;
+            ctx.rng.seed(seed, static_cast<uint64_t>(shuffle));
+            StatHist sim{};
+            for (int rep = 0; rep < SIM_REPS; ++rep) {
+                for (const auto& [before, after] : records) {
+                    ctx.deck = before;
+                    if (shuffle == Shuffle::Hindu) ctx.hindu();
+                    else                           ctx.overhand();
+                    add_stats(before, ctx.deck, sim);
+                }
+            }
+            return distance(observed, nObs, sim, nSim);
+        };
+
+        double best = simulate(model);
+        ++out.candidates;
+
+        for (int round = 0; round < SIM_ROUNDS; ++round) {
+            bool improved = false;
+
+            for (ModelTable t : free) {
+                for (int coord = 0; coord < 4; ++coord) { // min, max, centre, spread
+                    const CdfParams cur = out.fits[static_cast<int>(t)].params;
+                    std::vector<CdfParams> params;
+                    auto tryParams = [&](CdfParams p) { if (valid_params(p, t)) params.push_back(p); };
+
+                    for (int v = 0; v <= DECK_SIZE && coord < 3; ++v) {
+                        CdfParams p = cur;
+                        (coord == 0 ? p.min : coord == 1 ? p.max : p.centre) = v;
+                        tryParams(p);
+                    }
+                    if (coord == 3) {
+                        for (double s : spread_ladder(1.15)) { CdfParams p = cur; p.spread = s; tryParams(p); }
+                    }
+
+                    // tables built serially up front, candidates simulated across the pool
+                    std::vector<ShuffleModel> candidates(params.size(), model);
+                    for (std::size_t i = 0; i < params.size(); ++i) {
+                        candidates[i].tables[static_cast<int>(t)] = cache.get(params[i]);
+                    }
+                    std::vector<double> dist(params.size());
+                    pool.parallel_for(params.size(), [&](std::size_t i) { dist[i] = simulate(candidates[i]); });
+                    out.candidates += params.size();
+
+                    for (std::size_t i = 0; i < params.size(); ++i) {
+                        if (dist[i] < best - 1e-9) {
+                            best = dist[i];
+                            out.fits[static_cast<int>(t)].params = params[i];
+                            model.tables[static_cast<int>(t)] = candidates[i].tables[static_cast<int>(t)];
+                            improved = true;
+                        }
+                    }
+                }
+            }
+            if (!improved) break;
+        }
+
+        for (ModelTable t : free) {
+            TableFit& fit = out.fits[static_cast<int>(t)];
+            fit.method = TableFit::Method::Simulation;
+            fit.records = static_cast<int>(records.size());
+            fit.objective = best;
+        }
+    }
+
+    out.tablesBuilt = cache.size();
+    return out;
+}
@@ -0,0 +1,69 @@
+#include "Checkpoint.h"
+#include "BinaryIO.h"
+
+#include <cstring> // memcmp
+
+static constexpr char CHECKPOINT_MAGIC[8] = {'S', 'L', 'C', 'K', 'P', 'T', '0', '6'};
+
+bool save_checkpoint(const std::string& path, const Checkpoint& cp) {
+    return write_file_atomic(path, [&](BinaryWriter& w) {
+        w.put(CHECKPOINT_MAGIC);
+
+        put_experiment(w, cp.cfg);
+        w.put_vec(std::vector<char>(cp.cfg.outPath.begin(), cp.cfg.outPath.end()));
+
+        w.put<uint8_t>(cp.complete);
+        w.put_vec(cp.idx);
+        w.put_vec(cp.results);
+
+        w.put(cp.cfg.weights);
+        w.put_vec(cp.cfg.reweights);
+        w.put<int32_t>(cp.cfg.top);
+        for (const auto& list : cp.rankings.byObjective) w.put_vec(list);
+        w.put_vec(cp.rankings.byScore);
+        w.put_vec(cp.rankings.front);
+
+        w.put_vec(cp.bestSeqIdx);
+        w.put(cp.bestScore);
+        put_context(w, cp.bestShuffledDeck);
+    });
+}
+
+bool load_checkpoint(const std::string& path, Checkpoint& cp) {
+    return read_file(path, [&](BinaryReader& r) {
+        char magic[8] = {};
+        r.get(magic);
+        if (!r.ok || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+            r.ok = false;
+            return;
+        }
+
+        uint8_t complete = 0;
+        std::vector<char> outPath;
+        get_experiment(r, cp.cfg);
+        r.get_vec(outPath, 4096);
+        cp.cfg.outPath.assign(outPath.begin(), outPath.end());
+
+        r.get(complete);
+        cp.complete = complete;
+        r.get_vec(cp.idx, ExperimentRunner::K_MAX);
+        r.get_vec(cp.results, uint64_t(1) << (3 * ExperimentRunner::K_MAX));
+
+        int32_t top = 0;
+        r.get(cp.cfg.weights);
+        r.get_vec(cp.cfg.reweights, ExperimentRunner::REWEIGHTS_MAX);
+        r.get(top);
+        cp.cfg.top = top;
+        for (auto& list : cp.rankings.byObjective) r.get_vec(list, ExperimentRunner::TOP_MAX);
+        r.get_vec(cp.rankings.byScore, ExperimentRunner::TOP_MAX);
+        r.get_vec(cp.rankings.front, uint64_t(1) << (3 * ExperimentRunner::K_MAX));
+        if (r.ok && (top < 0 || top > ExperimentRunner::TOP_MAX)) r.ok = false;
+
+        r.get_vec(cp.bestSeqIdx, ExperimentRunner::K_MAX);
+        r.get(cp.bestScore);
+        get_context(r, cp.bestShuffledDeck);
+
+        // cursor must describe a sequence of the stored length
+        if (r.ok && static_cast<int>(cp.idx.size()) != cp.cfg.kMax) r.ok = false;
+    });
+}
@@ -0,0 +1,230 @@
+#include "ExactDistribution.h"
+#include "ExperimentRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring> // memcpy
+#include <unordered_map>
+
+namespace {
+
+struct DeckHash {
+    std::size_t operator()(const Deck& d) const noexcept {
+        uint64_t h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < DECK_SIZE; i += 8) {
+            uint64_t word = 0;
+            std::memcpy(&word, d.data() + i, std::min<std::size_t>(8, DECK_SIZE - i));
+            h = (h ^ word) * 1099511628211ULL;
+        }
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+using DeckMap = std::unordered_map<Deck, double, DeckHash>;
+
+std::array<double, DECK_SIZE> probs(const CdfTable& cdf) {
+    std::array<double, DECK_SIZE> p{};
+    for (int x = 0; x < DECK_SIZE; ++x) p[x] = static_cast<double>(cdf[x] - (x > 0 ? cdf[x - 1] : 0)) / cdf[DECK_SIZE - 1];
+    return p;
+}
+
+// Drop counts of an overhand: a draw of 0 moves no cards and is drawn again, so the
+// packet's drops follow the table conditioned on at least one card
+std::array<double, DECK_SIZE> drop_probs(const CdfTable& cdf) {
+    std::array<double, DECK_SIZE> p = probs(cdf);
+    const double moving = 1 - p[0];
+    p[0] = 0;
+    for (double& x : p) x = moving > 0 ? x / moving : 0;
+    return p;
+}
+
+// Orders one overhand packet of size cards can be dropped in: each drop either leaves
+// cards in the packet or (drawn at least as large as what is left) empties it
+double drop_orders(const std::array<double, DECK_SIZE>& drop, int size) {
+    std::vector<double> orders(size + 1, 0);
+    for (int left = 1; left <= size; ++left) {
+        bool empties = false;
+        for (int v = 1; v < DECK_SIZE; ++v) {
+            if (drop[v] <= 0) continue;
+            if (v < left) orders[left] += orders[left - v];
+            else          empties = true;
+        }
+        orders[left] += empties ? 1 : 0;
+    }
+    return orders[size];
+}
+
+// Every drop sequence of DeckContext::overhand for this cut point, as the kernel places
+// them: packet cards [dropped, cutPoint] still to drop, buffer filled down from n
+void overhand_drops(const Deck& deck, Deck& buffer, const std::array<double, DECK_SIZE>& drop,
+                    int cutPoint, int dropped, int n, double prob, DeckMap& out) {
+    if (n < 0) {
+        out[buffer] += prob;
+        return;
+    }
+
+    double empties = 0; // drop counts that take the rest of the packet
+    for (int v = 1; v < DECK_SIZE; ++v) {
+        if (drop[v] <= 0) continue;
+        const int dropPoint = dropped + v - 1;
+        if (dropPoint >= cutPoint) {
+            empties += drop[v];
+            continue;
+        }
+        int m = n;
+        for (int d = dropPoint; d >= dropped; --d) buffer[m--] = deck[d];
+        overhand_drops(deck, buffer, drop, cutPoint, dropPoint + 1, m, prob * drop[v], out);
+    }
+    if (empties > 0) {
+        int m = n;
+        for (int d = cutPoint; d >= dropped; --d) buffer[m--] = deck[d];
+        overhand_drops(deck, buffer, drop, cutPoint, cutPoint + 1, m, prob * empties, out);
+    }
+}
+
+} // namespace
+
+ExactDistribution::ExactDistribution() : decks{CANONICAL_DECK}, cumulative{1.0} {}
+
+double ExactDistribution::bound_after(Shuffle s, const ShuffleModel& model) const {
+    double perDeck = 0;
+    switch (s) {
+        case Shuffle::Cut:
+            for (double p : probs(model.table(ModelTable::Cut))) perDeck += p > 0;
+            break;
+        case Shuffle::Overhand: {
+            const auto cut = probs(model.table(ModelTable::OverhandCut));
+            const auto drop = drop_probs(model.table(ModelTable::OverhandDrop));
+            for (int c = 0; c < DECK_SIZE; ++c) {
+                if (cut[c] > 0) perDeck += drop_orders(drop, c + 1);
+            }
+            break;
+        }
+        case Shuffle::Riffle:
+        case Shuffle::Hindu:
+        case Shuffle::RandomTest:
+            return INFINITY;
+    }
+    return perDeck * static_cast<double>(decks.size());
+}
+
+ExactDistribution ExactDistribution::after(Shuffle s, const ShuffleModel& model) const {
+    DeckMap next;
+    next.reserve(static_cast<std::size_t>(std::min(bound_after(s, model), 1e7)));
+
+    Deck buffer;
+    for (std::size_t i = 0; i < decks.size(); ++i) {
+        const Deck& deck = decks[i];
+        const double prob = cumulative[i] - (i > 0 ? cumulative[i - 1] : 0);
+
+        if (s == Shuffle::Cut) {
+            const auto cut = probs(model.table(ModelTable::Cut));
+            for (int c = 0; c < DECK_SIZE; ++c) {
+                if (cut[c] <= 0) continue;
+                std::rotate_copy(deck.begin(), deck.begin() + c, deck.end(), buffer.begin()); // as perfect_cut
+                next[buffer] += prob * cut[c];
+            }
+        } else if (s == Shuffle::Overhand) {
+            const auto cut = probs(model.table(ModelTable::OverhandCut));
+            const auto drop = drop_probs(model.table(ModelTable::OverhandDrop));
+            for (int c = 0; c < DECK_SIZE; ++c) {
+                if (cut[c] <= 0) continue;
+                buffer = deck;
+                overhand_drops(deck, buffer, drop, c, 0, c, prob * cut[c], next);
+            }
+        }
+    }
+
+    std::vector<std::pair<Deck, double>> entries(next.begin(), next.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    ExactDistribution out;
+    out.decks.clear();
+    out.cumulative.clear();
+    out.decks.reserve(entries.size());
+    out.cumulative.reserve(entries.size());
+    double running = 0;
+    for (const auto& [deck, prob] : entries) {
+        running += prob;
+        out.decks.push_back(deck);
+        out.cumulative.push_back(running);
+    }
+    for (double& c : out.cumulative) c /= running; // rounding drift
+    return out;
+}
+
+const Deck& ExactDistribution::at(double u) const {
+    const auto it = std::upper_bound(cumulative.begin(), cumulative.end(), u);
+    return decks[std::min<std::size_t>(it - cumulative.begin(), decks.size() - 1)];
+}
+
+const ExactDistribution* ExactPrefixes::longest(const std::vector<Shuffle>& seq, int& steps) {
+    const ShuffleModel& model = default_model();
+    const ExactDistribution* dist = &sorted;
+    uint64_t code = 1;
+    steps = 0;
+
+    for (Shuffle s : seq) {
+        code = (code << 3) | static_cast<uint64_t>(s);
+
+        std::shared_ptr<Node> node;
+        {
+            std::lock_guard lock(mtx);
+            std::shared_ptr<Node>& slot = nodes[code];
+            if (!slot) {
+                slot = std::make_shared<Node>();
+                slot->prefix.assign(seq.begin(), seq.begin() + steps + 1);
+            }
+            node = slot;
+        }
+
+        // built by the first thread to get here, the rest wait for it
+        std::call_once(node->once, [&]() {
+            if (dist->bound_after(s, model) <= static_cast<double>(budget)) {
+                node->dist = std::make_unique<ExactDistribution>(dist->after(s, model));
+            }
+        });
+        if (!node->dist) break;
+
+        dist = node->dist.get();
+        ++steps;
+    }
+    return steps > 0 ? dist : nullptr;
+}
+
+std::vector<ExactPrefixes::Tracked> ExactPrefixes::tracked() const {
+    std::vector<Tracked> out;
+    std::lock_guard lock(mtx);
+    for (const auto& [code, node] : nodes) {
+        if (node->dist) out.push_back({node->prefix, node->dist->support()});
+    }
+    std::stable_sort(out.begin(), out.end(), [](const Tracked& a, const Tracked& b) { return a.prefix.size() < b.prefix.size(); });
+    return out;
+}
+
+// ===== Exact Prefix Runs =====
+
+void ExperimentRunner::prepare_exact() {
+    exactPrefixes = std::make_shared<ExactPrefixes>(static_cast<std::size_t>(cfg.exactBudget));
+}
+
+// Trials start from the exact distribution after the sequence's tracked prefix instead of
+// the sorted deck. They take it at evenly spaced probabilities (one random offset shared
+// by all), so the decks sampled follow the distribution as closely as cfg.trials allow,
+// and only the remaining shuffles are simulated.
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_exact(DeckContext& ctx, const std::vector<int>& idx,
+                                                                 const ExactDistribution& dist, int steps) {
+    constexpr double OFFSET_SCALE = 1.0 / (1u << 24);
+    const double offset = (ctx.rng.random_bounded(1u << 24) + 0.5) * OFFSET_SCALE;
+
+    for (int t = 0; t < cfg.trials; ++t) {
+        ctx.deck = dist.at((t + offset) / cfg.trials);
+        ctx.numShuffles += steps;
+        for (std::size_t s = steps; s < idx.size(); ++s) {
+            apply_shuffle(ctx, allowed[idx[s]]);
+        }
+        observe_trial(ctx);
+    }
+
+    return summarise(ctx);
+}
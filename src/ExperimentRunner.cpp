@@ -1,11 +1,67 @@
 #include "ExperimentRunner.h"
+#include "Checkpoint.h"
+#include "ExactDistribution.h"
+#include "PermutationPool.h"
+#include "Pipeline.h"
+#include "Profile.h"
+#include "Ranking.h"
+#include "ResultCache.h"
+#include "ShardResult.h"
+#include "ThreadPool.h"
 #include "UI.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <limits>
+#include <memory>
 
-ExperimentRunner::ExperimentRunner(const ExperimentConfig& cfg) : cfg(cfg), allowed{Shuffle::Cut, Shuffle::Riffle, Shuffle::Hindu, Shuffle::Overhand} {}
+
+ExperimentRunner::ExperimentRunner(const ExperimentConfig& cfg) : cfg(cfg), allowed{Shuffle::Cut, Shuffle::Riffle, Shuffle::Hindu, Shuffle::Overhand} {
+    if (!cfg.shuffles.empty()) allowed = cfg.shuffles;
+}
+
+void ExperimentRunner::share(ThreadPool* pool, ResultCache* cache) {
+    sharedPool = pool;
+    sharedCache = cache;
+}
+
+ThreadPool& ExperimentRunner::workers() {
+    if (sharedPool) return *sharedPool;
+    if (!ownPool) ownPool = std::make_shared<ThreadPool>(cfg.threads);
+    return *ownPool;
+}
+
+// Sequences the after-sweep checks re-run: the best one first, then up to count more of
+// its length taken at even steps through the enumeration, so every region is represented
+std::vector<std::vector<int>> ExperimentRunner::check_sequences(const std::vector<int>& bestSeqIdx, uint64_t count) const {
+    const int base = num_shuffles();
+    const int length = static_cast<int>(bestSeqIdx.size());
+    const uint64_t total = num_sequences(length, base);
+    const uint64_t spread = std::min<uint64_t>(count, total);
+
+    std::vector<std::vector<int>> seqs = {bestSeqIdx};
+    for (uint64_t i = 0; i < spread; ++i) {
+        std::vector<int> idx = sequence_from_rank(total * i / spread, length, base);
+        if (idx != bestSeqIdx) seqs.push_back(std::move(idx));
+    }
+    return seqs;
+}
+
+std::vector<Shuffle> ExperimentRunner::shuffles_of(const std::vector<int>& idx) const {
+    std::vector<Shuffle> seq;
+    for (int i : idx) seq.push_back(allowed[i]);
+    return seq;
+}
 
 void ExperimentRunner::apply_shuffle(DeckContext& ctx, Shuffle s) {
+    PROFILE_SCOPE(profile::shuffle_stage(s));
     ++ctx.numShuffles;
+    if (permutations && s != Shuffle::RandomTest) {
+        permutations->apply(ctx, s);
+        return;
+    }
     switch (s) {
         case Shuffle::RandomTest:
             ctx.random_test_shuffle(); break;
@@ -29,15 +85,73 @@ bool ExperimentRunner::next_sequence(std::vector<int>& idx, int base) {
     return false;
 }
 
+uint64_t ExperimentRunner::num_sequences(int k, int base) {
+    uint64_t n = 1;
+    for (int i = 0; i < k; ++i) n *= base;
+    return n;
+}
+
+uint64_t ExperimentRunner::sequence_rank(const std::vector<int>& idx, int base) {
+    uint64_t rank = 0;
+    for (int i : idx) rank = rank * base + i;
+    return rank;
+}
+
+std::vector<int> ExperimentRunner::sequence_from_rank(uint64_t rank, int k, int base) {
+    std::vector<int> idx(k, 0);
+    for (int i = k - 1; i >= 0; --i) {
+        idx[i] = static_cast<int>(rank % base);
+        rank /= base;
+    }
+    return idx;
+}
+
+bool ExperimentRunner::same_experiment(const ExperimentConfig& a, const ExperimentConfig& b) {
+    return a.kMax == b.kMax && a.trials == b.trials && a.seed == b.seed &&
+           a.testUniformity == b.testUniformity && a.testAdjacency == b.testAdjacency &&
+           a.testMixing == b.testMixing && a.testPoker == b.testPoker && a.pokerSeats == b.pokerSeats &&
+           a.streamHands == b.streamHands && a.streamWarmup == b.streamWarmup && a.collect == b.collect &&
+           a.shuffles == b.shuffles;
+}
+
+// Contiguous, disjoint slices covering [0, n^k) - shard sizes differ by at most one
+std::pair<uint64_t, uint64_t> ExperimentRunner::shard_range(const ExperimentConfig& cfg, int base) {
+    const uint64_t total = num_sequences(cfg.kMax, base);
+    const uint64_t i = cfg.shardIndex, n = cfg.shardCount;
+    return {total * i / n, total * (i + 1) / n};
+}
+
+// Expected values (theoretical / emprirical baseline) 
+static constexpr double MEAN_UNIFORMITY_TARGET = 51.0;
+static constexpr double MEAN_ADJACENCY_TARGET = 50.0;
+static constexpr double MEAN_DISPLACEMENT_TARGET = 17.33;
+
+bool ExperimentRunner::weights_valid(const ExperimentConfig& cfg) {
+    auto weighted = [&](const ScoreWeights& w) {
+        return (cfg.testUniformity && w.uniformity > 0) || (cfg.testAdjacency && w.adjacency > 0) ||
+               (cfg.testMixing && w.displacement > 0) || (cfg.testPoker && w.poker > 0);
+    };
+    if (!weighted(cfg.weights)) return false;
+    for (const ScoreWeights& w : cfg.reweights) {
+        if (!weighted(w)) return false;
+    }
+    return true;
+}
+
 double ExperimentRunner::score(double seqMeanUniformity,
              double seqMeanAdjacency,
-             double seqMeanDisplacement)
+             double seqMeanDisplacement,
+             double seqPokerChiSqDf)
 {
-    // Expected values (theoretical / emprirical baseline) 
-    constexpr double MEAN_UNIFORMITY_TARGET = 51.0;
-    constexpr double MEAN_ADJACENCY_TARGET = 50.0;
-    constexpr double MEAN_DISPLACEMENT_TARGET = 17.33;
+    return score(cfg.weights, seqMeanUniformity, seqMeanAdjacency, seqMeanDisplacement, seqPokerChiSqDf);
+}
 
+double ExperimentRunner::score(const ScoreWeights& w,
+             double seqMeanUniformity,
+             double seqMeanAdjacency,
+             double seqMeanDisplacement,
+             double seqPokerChiSqDf)
+{
     // Inverse standard deviation used to convert deviation into z-score.
     // For chi-square distribution: StdDev = sqrt(2·df), so InvStdDev = 1 / sqrt(2·df).
 
@@ -49,12 +163,6 @@ double ExperimentRunner::score(double seqMeanUniformity,
     // Expected mean ≈ 17.3269, empirical StdDev ≈ 3 → InvStdDev ≈ 1/3.
     constexpr double DISPLACEMENT_INV_STDDEV = 0.333333;
 
-    constexpr double W_UNIFORMITY = 0.25;
-    constexpr double W_ADJACENCY = 0.7;    
-    constexpr double W_DISPLACEMENT = 0.05;
-
-    
-
     double score = 0.0; // lower = less deviation / closer to expected value
     double weightSum = 0.0;
 
@@ -65,20 +173,29 @@ double ExperimentRunner::score(double seqMeanUniformity,
     // Absoloute deviation from ideal
     if (seqMeanUniformity != -1) {
         double z = (seqMeanUniformity - MEAN_UNIFORMITY_TARGET) * UNIFORMITY_INV_STDDEV;
-        score += W_UNIFORMITY * z * z;
-        weightSum += W_UNIFORMITY;
+        score += w.uniformity * z * z;
+        weightSum += w.uniformity;
     }
 
     if (seqMeanAdjacency != -1) {
         double z = (seqMeanAdjacency - MEAN_ADJACENCY_TARGET) * ADJACENCY_INV_STDDEV;
-        score += W_ADJACENCY * z * z;
-        weightSum += W_ADJACENCY;
+        score += w.adjacency * z * z;
+        weightSum += w.adjacency;
     }
 
     if (seqMeanDisplacement != -1) {
         double z = (seqMeanDisplacement - MEAN_DISPLACEMENT_TARGET) * DISPLACEMENT_INV_STDDEV;
-        score += W_DISPLACEMENT * z * z;
-        weightSum += W_DISPLACEMENT;
+        score += w.displacement * z * z;
+        weightSum += w.displacement;
+    }
+
+    // Reduced χ² (χ² / df): expected 1, StdDev = sqrt(2 / df)
+    if (seqPokerChiSqDf != -1) {
+        const int seats = cfg.pokerSeats;
+        const double df = seats * 6 + (seats - 1); // see report_poker
+        double z = (seqPokerChiSqDf - 1.0) * std::sqrt(df / 2.0);
+        score += w.poker * z * z;
+        weightSum += w.poker;
     }
 
     // Normalise so socre comparable if tests are disabled
@@ -86,75 +203,627 @@ double ExperimentRunner::score(double seqMeanUniformity,
 
 }
 
-void ExperimentRunner::run() {
-    
+// Best score a sequence can reach once its mean adjacency χ² is known to be at least
+// seqMeanAdjacency - every other enabled test is taken to hit its target exactly
+double ExperimentRunner::score_lower_bound(double seqMeanAdjacency) {
+    if (!cfg.testAdjacency || seqMeanAdjacency <= MEAN_ADJACENCY_TARGET) return 0.0;
+    return score(cfg.testUniformity ? MEAN_UNIFORMITY_TARGET : -1,
+                 seqMeanAdjacency,
+                 cfg.testMixing ? MEAN_DISPLACEMENT_TARGET : -1,
+                 cfg.testPoker ? 1.0 : -1);
+}
 
-    print_experiment_overview(cfg, allowed.size());
+std::array<double, ExperimentRunner::OBJECTIVES> ExperimentRunner::deviations(const SequenceResult& r) {
+    auto dev = [](double value, double target) { return value == -1 ? 0.0 : std::fabs(value - target); };
+    return {dev(r.uniformity, MEAN_UNIFORMITY_TARGET), dev(r.adjacency, MEAN_ADJACENCY_TARGET),
+            dev(r.displacement, MEAN_DISPLACEMENT_TARGET), dev(r.poker, 1.0)};
+}
 
+// Best of the front under each alternative weighting. score() only grows as a statistic
+// moves away from its target, so no sequence off the front can beat it.
+void ExperimentRunner::reweigh(Rankings& rankings) {
+    rankings.reweighted.clear();
+    for (const ScoreWeights& w : cfg.reweights) {
+        SequenceResult best;
+        best.score = std::numeric_limits<double>::infinity();
+        for (const SequenceResult& r : rankings.front) { // rank order: ties keep the lower rank
+            const double s = score(w, r.uniformity, r.adjacency, r.displacement, r.poker);
+            if (s < best.score) {
+                best = r;
+                best.score = s;
+            }
+        }
+        rankings.reweighted.push_back(best);
+    }
+}
+
+// Unique per sequence of shuffle types (3 bits per step + leading sentinel), so a
+// sequence's RNG stream does not depend on where it sits in the enumeration
+uint64_t ExperimentRunner::sequence_code(const std::vector<int>& idx) const {
+    uint64_t code = 1;
+    for (int i : idx) {
+        code = (code << 3) | static_cast<uint64_t>(allowed[i]);
+    }
+    return code;
+}
+
+// Enabled tests as bits (uniformity, adjacency, mixing, poker + seats, trial scheme) - part of a cached result's key
+uint32_t ExperimentRunner::tests_mask() const {
+    return (cfg.testUniformity ? 1u : 0u) | (cfg.testAdjacency ? 2u : 0u) | (cfg.testMixing ? 4u : 0u) |
+           (cfg.testPoker ? 8u | (static_cast<uint32_t>(cfg.pokerSeats) << 8) : 0u) |
+           (cfg.sharePrefixes ? 16u : 0u) | // different trials, different results
+           (permutations ? 32u : 0u) | (cfg.stratify ? 64u : 0u) | (exactPrefixes ? 128u : 0u);
+}
+
+// What a cached result depends on besides its sequence (the caller sets seqCode)
+ResultCache::Key ExperimentRunner::cache_key() const {
+    ResultCache::Key key;
+    key.modelHash = model_hash();
+    if (permutations) key.modelHash = (key.modelHash ^ permutations->fingerprint()) * 1099511628211ull; // results of this pool only
+    if (exactPrefixes) key.modelHash = (key.modelHash ^ static_cast<uint64_t>(cfg.exactBudget)) * 1099511628211ull; // which prefixes are exact
+    key.seed = cfg.seed;
+    key.trials = cfg.streamHands > 0 ? cfg.streamHands : cfg.trials;
+    key.tests = tests_mask();
+    return key;
+}
+
+// One trial: sorted deck through every shuffle of the sequence
+void ExperimentRunner::shuffle_trial(DeckContext& ctx, const std::vector<int>& idx) {
+    ctx.reset(); // sorts deck
+
+    for (int i : idx) {
+        apply_shuffle(ctx, allowed[i]);
+    }
+}
+
+// Update relevant stats with ctx.deck (displacement from collected if given, else from sorted)
+void ExperimentRunner::observe_trial(DeckContext& ctx, const Deck* collected) {
+    if (cfg.testAdjacency)  { PROFILE_SCOPE(profile::ObserveAdjacency);    ctx.observe_adjacency(); }
+    if (cfg.testUniformity) { PROFILE_SCOPE(profile::ObserveUniformity);   ctx.observe_uniformity(); }
+    if (cfg.testMixing) {
+        PROFILE_SCOPE(profile::ObserveDisplacement);
+        if (collected) ctx.observe_displacement(*collected);
+        else           ctx.observe_displacement();
+    }
+    if (cfg.testPoker)      { PROFILE_SCOPE(profile::ObservePoker);        ctx.observe_poker(cfg.pokerSeats); }
+}
+
+// Aggregate statistical data across trials
+ExperimentRunner::SequenceResult ExperimentRunner::summarise(const DeckContext& ctx) {
+    SequenceResult r;
+    if (cfg.testUniformity) { PROFILE_SCOPE(profile::ReportUniformity);   r.uniformity = report_uniformity(ctx).meanChiSq; }
+    if (cfg.testAdjacency)  { PROFILE_SCOPE(profile::ReportAdjacency);    r.adjacency = report_adjacency(ctx).meanChiSq; }
+    if (cfg.testMixing)     { PROFILE_SCOPE(profile::ReportDisplacement); r.displacement = report_displacement(ctx).mean; }
+    if (cfg.testPoker)      { PROFILE_SCOPE(profile::ReportPoker);        r.poker = report_poker(ctx, cfg.pokerSeats).reducedChiSq; }
+
+    r.score = score(r.uniformity, r.adjacency, r.displacement, r.poker); // NEED TO NORMALISE
+    return r;
+}
+
+// Run all trials of one sequence into ctx (fresh accumulators), returns its summary
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_sequence(DeckContext& ctx, const std::vector<int>& idx) {
+    if (cfg.streamHands > 0) return evaluate_stream(ctx, idx);
+    if (cfg.sharePrefixes) return evaluate_shared(ctx, idx);
+    if (cfg.stratify) return evaluate_stratified(ctx, idx);
+
+    ctx.rng.seed(cfg.seed, sequence_code(idx)); // reproducible regardless of run order
+
+    if (exactPrefixes) {
+        int steps = 0;
+        if (const ExactDistribution* dist = exactPrefixes->longest(shuffles_of(idx), steps)) {
+            return evaluate_exact(ctx, idx, *dist, steps);
+        }
+    }
+
+    for (int t = 0; t < cfg.trials; ++t) {
+        shuffle_trial(ctx, idx);
+        observe_trial(ctx);
+    }
+
+    return summarise(ctx);
+}
+
+// Game cycle: one deck played hand after hand - deal, collect, reshuffle with the
+// sequence, observe. Only the accumulators grow, so memory is fixed however long the stream.
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_stream(DeckContext& ctx, const std::vector<int>& idx) {
+    ctx.rng.seed(cfg.seed, sequence_code(idx));
+    ctx.reset(); // new deck out of the box
+
+    Deck collected;
+    const int hands = cfg.streamWarmup + cfg.streamHands;
+
+    for (int hand = 0; hand < hands; ++hand) {
+        if (hand == cfg.streamWarmup) ctx.numShuffles = 0; // reports count observed shuffles only
+
+        if (hand > 0) {
+            switch (cfg.collect) {
+                case CollectModel::Sorted: ctx.reset(); break;
+                case CollectModel::Keep:   break;
+                case CollectModel::Piles:  ctx.collect_piles(cfg.pokerSeats); break;
+            }
+        }
+        collected = ctx.deck;
+
+        for (int i : idx) {
+            apply_shuffle(ctx, allowed[i]);
+        }
+
+        if (hand >= cfg.streamWarmup) observe_trial(ctx, &collected);
+    }
+
+    return summarise(ctx);
+}
+
+// Shuffle model fingerprint, extended by the game-cycle settings when streaming
+uint64_t ExperimentRunner::model_hash() const {
+    uint64_t h = model_fingerprint();
+    if (cfg.streamHands > 0) {
+        for (uint64_t v : {uint64_t(cfg.streamWarmup), uint64_t(cfg.collect), uint64_t(cfg.pokerSeats)}) {
+            h = (h ^ v) * 1099511628211ull; // FNV-1a step
+        }
+    }
+    return h;
+}
+
+// Set by SIGINT/SIGTERM while checkpointing, sweep saves and stops at the next sequence
+static volatile std::sig_atomic_t stopRequested = 0;
+static void request_stop(int) { stopRequested = 1; }
+
+ExperimentRunner::SweepOutcome ExperimentRunner::sweep(const Checkpoint* resume) {
     const int base = static_cast<int>(allowed.size());
 
-    std::vector<int> bestSeqIdx;  
+    SweepOutcome out;
+    std::vector<int>& bestSeqIdx = out.bestSeqIdx;
     // radix enumerator needs to be altered to be compatible when allowed != Shuffle Enum
-    DeckContext bestShuffledDeck;
-    double bestScore = std::numeric_limits<double>::infinity();
+    DeckContext& bestShuffledDeck = out.bestShuffledDeck;
+    double& bestScore = out.bestScore;
+    bestScore = std::numeric_limits<double>::infinity();
 
     // Compute t trials for n^k sequences of size k (n = # unique shuffle types)
     //for (int k = 1; k <= cfg.kMax; ++k) {
     int k = cfg.kMax;
-        
-        std::vector<int> idx(k, 0);
-        bool hasNext = true;
 
-        while (hasNext) {
+        // shard slice of the enumeration (whole space when unsharded)
+        const auto [begin, end] = shard_range(cfg, base);
+
+        std::vector<int> idx = sequence_from_rank(begin, k, base);
+        uint64_t rank = begin;
+        std::vector<SequenceResult>& results = out.results; // only kept when writing a result file
+        const bool keepResults = !cfg.outPath.empty();
+        RankingTracker tracker(cfg.top); // only fed when keeps_rankings()
+
+        if (resume) {
+            idx = resume->idx;
+            rank = resume->complete ? end : sequence_rank(idx, base);
+            results = resume->results;
+            tracker.restore(resume->rankings);
+            if (!resume->bestSeqIdx.empty()) {
+                bestSeqIdx = resume->bestSeqIdx;
+                bestScore = resume->bestScore;
+                bestShuffledDeck = resume->bestShuffledDeck;
+            }
+        }
+
+        if (keepResults) results.reserve(end - begin);
 
-            // Aggregate Stat Initialisation
-            double seqMeanUniformity = cfg.testUniformity ? 0 : -1;
-            double seqMeanAdjacency = cfg.testAdjacency ? 0 : -1;
-            double seqMeanDisplacement = cfg.testMixing ? 0 : -1;
+        // replicate scores, B per sequence in rank order (--bootstrap, never resumed)
+        std::vector<float> replicates;
+        if (cfg.bootstrap > 0) {
+            replicates.resize((end - begin) * cfg.bootstrap);
+            out.bootstrap.reserve(end - begin);
+        }
 
-            DeckContext ctx; // better to use reset function?
+        // results of previous runs with the same models, sequence, trials, seed and tests
+        // (a manifest shares one across its experiments, see share())
+        std::unique_ptr<ResultCache> ownCache;
+        if (!sharedCache && !cfg.cachePath.empty()) ownCache = std::make_unique<ResultCache>(cfg.cachePath);
+        ResultCache* cache = sharedCache ? sharedCache : ownCache.get();
+        const ResultCache::Key cacheKey = cache_key();
+
+        const bool checkpointing = !cfg.checkpointPath.empty();
+        auto lastCheckpoint = std::chrono::steady_clock::now();
+
+        auto save = [&]() {
+            Checkpoint cp;
+            cp.cfg = cfg;
+            cp.complete = rank >= end;
+            cp.idx = idx;
+            cp.results = results;
+            if (keeps_rankings()) cp.rankings = tracker.rankings();
+            cp.bestSeqIdx = bestSeqIdx;
+            cp.bestScore = bestScore;
+            cp.bestShuffledDeck = bestShuffledDeck;
+            if (ownCache && !ownCache->flush()) {
+                std::cerr << "warning: failed to write cache " << cfg.cachePath << "\n";
+            }
+            if (!save_checkpoint(cfg.checkpointPath, cp)) {
+                std::cerr << "warning: failed to write checkpoint " << cfg.checkpointPath << "\n";
+            }
+            lastCheckpoint = std::chrono::steady_clock::now();
+        };
 
-            for (int t = 0; t < cfg.trials; ++t) {
-                
-                ctx.reset(); // sorts deck
-                
-                for (int step = 0; step < k; ++step) {
-                    apply_shuffle(ctx, allowed[idx[step]]);
+        if (checkpointing) {
+            std::signal(SIGINT, request_stop);
+            std::signal(SIGTERM, request_stop);
+        }
+
+        // Sequences are evaluated in blocks across the pool, then folded in enumeration
+        // order - checkpoints, cache inserts and best selection stay serial and deterministic
+        ThreadPool& pool = workers();
+        uint64_t blockSize = static_cast<uint64_t>(pool.size()) * 16;
+
+        // Shared prefixes: whole groups per task, so blocks hold whole groups (the sweep
+        // always starts at rank 0 - no shards or resumes in this mode)
+        const int groupDepth = std::min(k, PREFIX_GROUP_DEPTH);
+        const uint64_t groupSize = num_sequences(groupDepth, base);
+        if (cfg.sharePrefixes) blockSize = (blockSize + groupSize - 1) / groupSize * groupSize;
+        std::vector<SequenceResult> block;
+        std::vector<uint8_t> simulated;
+
+        // Pipelined: cache lookups stay on the pool, misses stream through shuffle -> stats stages
+        std::unique_ptr<DeckPipeline> pipeline;
+        std::vector<std::size_t> pending; // block slots to simulate
+        DeckPipeline::Stages stages;
+        if (cfg.pipelineShuffleWorkers > 0 && cfg.streamHands == 0) {
+            pipeline = std::make_unique<DeckPipeline>(cfg.pipelineShuffleWorkers, cfg.pipelineStatsWorkers);
+            blockSize = std::max<uint64_t>(blockSize, static_cast<uint64_t>(cfg.pipelineShuffleWorkers + cfg.pipelineStatsWorkers) * 16);
+
+            stages.produce = [&](std::size_t job, DeckContext& ctx, DeckSink& sink) {
+                const std::vector<int> seqIdx = sequence_from_rank(block[pending[job]].rank, k, base);
+                ctx.rng.seed(cfg.seed, sequence_code(seqIdx)); // same stream as evaluate_sequence
+                for (int t = 0; t < cfg.trials; ++t) {
+                    shuffle_trial(ctx, seqIdx);
+                    sink.push(ctx.deck);
                 }
+            };
+            stages.observe = [&](DeckContext& acc) { observe_trial(acc); };
+            stages.finish = [&](std::size_t job, const DeckContext& acc) {
+                SequenceResult& seq = block[pending[job]];
+                const uint64_t seqRank = seq.rank;
+                seq = summarise(acc);
+                seq.rank = seqRank;
+            };
+        }
 
-                // Update relevant stats
-                if (cfg.testAdjacency)  ctx.observe_adjacency();
-                if (cfg.testUniformity) ctx.observe_uniformity();
-                if (cfg.testMixing)     ctx.observe_displacement();
+        while (rank < end) {
+
+            const uint64_t blockEnd = std::min(end, rank + blockSize);
+            const std::size_t n = blockEnd - rank;
+            block.assign(n, SequenceResult{});
+            simulated.assign(n, 1);
+
+            pool.parallel_for(n, [&](std::size_t i) {
+                const uint64_t seqRank = rank + i;
+                const std::vector<int> seqIdx = sequence_from_rank(seqRank, k, base);
+                SequenceResult& seq = block[i];
+
+                if (cache) {
+                    ResultCache::Key key = cacheKey;
+                    key.seqCode = sequence_code(seqIdx);
+                    ResultCache::Value cached;
+                    if (cache->lookup(key, cached)) {
+                        seq.uniformity = cached.uniformity;
+                        seq.adjacency = cached.adjacency;
+                        seq.displacement = cached.displacement;
+                        seq.poker = cached.poker;
+                        seq.score = score(seq.uniformity, seq.adjacency, seq.displacement, seq.poker);
+                        simulated[i] = 0;
+                    }
+                }
+
+                if (simulated[i] && !pipeline && !cfg.sharePrefixes) {
+                    DeckContext ctx; // better to use reset function?
+                    if (cfg.bootstrap > 0) seq = evaluate_bootstrap(ctx, seqIdx, &replicates[(seqRank - begin) * cfg.bootstrap]);
+                    else                   seq = evaluate_sequence(ctx, seqIdx);
+                }
+                seq.rank = seqRank;
+            });
+
+            if (cfg.sharePrefixes) {
+                pool.parallel_for(n / groupSize, [&](std::size_t g) {
+                    const std::size_t first = g * groupSize;
+                    if (std::find(&simulated[first], &simulated[first] + groupSize, 1) == &simulated[first] + groupSize) return;
+
+                    std::vector<SequenceResult> group(groupSize);
+                    evaluate_group(rank + first, groupDepth, group.data());
+                    for (std::size_t i = 0; i < groupSize; ++i) {
+                        if (simulated[first + i]) block[first + i] = group[i]; // cached ones are equal
+                    }
+                });
             }
 
-            // Aggregate statistical data across trials
-            if (cfg.testUniformity) {
-                seqMeanUniformity = report_uniformity(ctx).meanChiSq;
+            if (pipeline) {
+                pending.clear();
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (simulated[i]) pending.push_back(i);
+                }
+                pipeline->run(pending.size(), stages);
             }
 
-            if (cfg.testAdjacency) {
-                seqMeanAdjacency = report_adjacency(ctx).meanChiSq;
+            // Update best sequence (first strictly better in enumeration order)
+            const SequenceResult* blockBest = nullptr;
+            for (std::size_t i = 0; i < n; ++i) {
+                const SequenceResult& seq = block[i];
+
+                if (cache) {
+                    if (simulated[i]) {
+                        ResultCache::Key key = cacheKey;
+                        key.seqCode = sequence_code(sequence_from_rank(seq.rank, k, base));
+                        cache->insert(key, {seq.uniformity, seq.adjacency, seq.displacement, seq.poker});
+                        ++out.cacheMisses;
+                    } else {
+                        ++out.cacheHits;
+                    }
+                }
+
+                if (seq.score < bestScore && (!blockBest || seq.score < blockBest->score)) {
+                    blockBest = &seq;
+                }
+                if (keepResults) results.push_back(seq);
+                if (keeps_rankings()) tracker.offer(seq);
+                if (cfg.bootstrap > 0) out.bootstrap.push_back({seq.rank, seq.score});
             }
 
-            if (cfg.testMixing) {
-                seqMeanDisplacement = report_displacement(ctx).mean;
+            if (blockBest) {
+                bestSeqIdx = sequence_from_rank(blockBest->rank, k, base);
+                bestScore = blockBest->score;
+                bestShuffledDeck = DeckContext{};
+                evaluate_sequence(bestShuffledDeck, bestSeqIdx); // deterministic replay for the report
             }
 
+            out.sequences += n;
+            rank = blockEnd;
+            if (rank < end) idx = sequence_from_rank(rank, k, base);
 
-            // Update best sequence
-            double seqScore = score(seqMeanUniformity, seqMeanAdjacency, seqMeanDisplacement); // NEED TO NORMALISE
-            if (seqScore < bestScore) {
-                bestShuffledDeck = ctx;
-                bestSeqIdx = idx;
-                bestScore = seqScore;
+            if (checkpointing && (stopRequested ||
+                std::chrono::steady_clock::now() - lastCheckpoint >= std::chrono::seconds(cfg.checkpointInterval))) {
+                save();
             }
 
-            hasNext = next_sequence(idx, base);
+            if (stopRequested && rank < end) {
+                out.complete = false;
+                return out;
+            }
+        }
+
+        if (cfg.bootstrap > 0) summarise_bootstrap(pool, replicates, out.bootstrap);
+
+        if (keeps_rankings()) {
+            out.rankings = tracker.rankings();
+            reweigh(out.rankings);
+        }
+
+        if (cache) {
+            if (ownCache && !checkpointing && !ownCache->flush()) {
+                std::cerr << "warning: failed to write cache " << cfg.cachePath << "\n";
+            }
+            out.cacheEntries = cache->size();
+        }
+
+        if (checkpointing) {
+            save(); // final state, resuming just reprints the results
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
         }
     //}
 
-    print_experiment_results(cfg, bestShuffledDeck, bestSeqIdx, allowed.size());
+    out.complete = true;
+    return out;
+}
+
+std::vector<ExperimentRunner::SequenceResult> ExperimentRunner::evaluate_batch(const std::vector<std::vector<Shuffle>>& seqs, uint64_t& reused) {
+    std::unique_ptr<ResultCache> ownCache;
+    if (!sharedCache && !cfg.cachePath.empty()) ownCache = std::make_unique<ResultCache>(cfg.cachePath);
+    ResultCache* cache = sharedCache ? sharedCache : ownCache.get();
+    const ResultCache::Key cacheKey = cache_key();
+
+    ThreadPool& pool = workers();
+
+    std::vector<SequenceResult> out(seqs.size());
+    std::vector<uint8_t> simulated(seqs.size(), 1);
+    std::vector<uint64_t> codes(seqs.size());
+
+    pool.parallel_for(seqs.size(), [&](std::size_t i) {
+        std::vector<int> idx;
+        for (Shuffle s : seqs[i]) idx.push_back(static_cast<int>(std::find(allowed.begin(), allowed.end(), s) - allowed.begin()));
+        codes[i] = sequence_code(idx);
+        SequenceResult& seq = out[i];
+
+        if (cache) {
+            ResultCache::Key key = cacheKey;
+            key.seqCode = codes[i];
+            ResultCache::Value cached;
+            if (cache->lookup(key, cached)) {
+                seq.uniformity = cached.uniformity;
+                seq.adjacency = cached.adjacency;
+                seq.displacement = cached.displacement;
+                seq.poker = cached.poker;
+                seq.score = score(seq.uniformity, seq.adjacency, seq.displacement, seq.poker);
+                simulated[i] = 0;
+            }
+        }
+
+        if (simulated[i]) {
+            DeckContext ctx;
+            seq = evaluate_sequence(ctx, idx);
+        }
+        seq.rank = i;
+    });
+
+    reused = 0;
+    for (std::size_t i = 0; i < seqs.size(); ++i) {
+        if (!simulated[i]) {
+            ++reused;
+        } else if (cache) {
+            ResultCache::Key key = cacheKey;
+            key.seqCode = codes[i];
+            const SequenceResult& seq = out[i];
+            cache->insert(key, {seq.uniformity, seq.adjacency, seq.displacement, seq.poker});
+        }
+    }
+
+    if (ownCache && !ownCache->flush()) {
+        std::cerr << "warning: failed to write cache " << cfg.cachePath << "\n";
+    }
+    return out;
+}
+
+void ExperimentRunner::run(const Checkpoint* resume) {
+    
+
+    print_experiment_overview(cfg, allowed.size());
+
+    if (resume) {
+        std::cout << "\nResuming from checkpoint" << (resume->complete ? " (sweep already complete)" : "") << "\n";
+    }
+
+    if (cfg.poolSize > 0) {
+        bool mapped = false;
+        double seconds = 0;
+        prepare_pool(mapped, seconds);
+        std::cout << "\nPermutation pools     : " << (mapped ? "mapped from " + cfg.poolPath : "built")
+                  << " in " << seconds << " s" << (!mapped && !cfg.poolPath.empty() ? ", saved to " + cfg.poolPath : "") << "\n";
+    }
+
+    if (cfg.exactBudget > 0) prepare_exact();
+
+    if (cfg.profile) profile::enable();
+    const auto sweepStart = std::chrono::steady_clock::now();
+
+    if (!cfg.exploitSequence.empty()) {
+        ExploitOutcome outcome = exploit();
+
+        if (cfg.profile) {
+            profile::print_report(std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count());
+        }
+
+        print_exploit(cfg, outcome);
+        return;
+    }
+
+    if (cfg.timeBudget > 0) {
+        SearchOutcome outcome = budget_search();
+
+        if (cfg.profile) {
+            profile::print_report(std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count());
+        }
+
+        print_search_summary(cfg, outcome);
+        if (!outcome.bestSeqIdx.empty()) {
+            if (permutations) print_pool_check(cfg, check_pool(outcome.bestSeqIdx));
+            print_experiment_results(cfg, outcome.bestShuffledDeck, outcome.bestSeqIdx, allowed.size());
+        }
+        return;
+    }
+
+    if (cfg.beamWidth > 0) {
+        BeamOutcome outcome = beam_search();
+
+        if (cfg.profile) {
+            profile::print_report(std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count());
+        }
+
+        print_beam_summary(outcome);
+        if (permutations) print_pool_check(cfg, check_pool(outcome.bestSeqIdx));
+        print_experiment_results(cfg, outcome.bestShuffledDeck, outcome.bestSeqIdx, allowed.size());
+        return;
+    }
+
+    SweepOutcome outcome = sweep(resume);
+
+    if (cfg.profile) {
+        profile::print_report(std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count());
+    }
+
+    if (!outcome.complete) {
+        std::cout << "\n\nInterrupted - continue with --resume " << cfg.checkpointPath << "\n";
+        return;
+    }
+
+    if (!cfg.cachePath.empty()) {
+        std::cout << "\n\nCache: " << outcome.cacheHits << " hits, " << outcome.cacheMisses
+                  << " simulated (" << outcome.cacheEntries << " entries in " << cfg.cachePath << ")";
+    }
+
+    if (!cfg.outPath.empty()) {
+        ShardResult out;
+        out.cfg = cfg;
+        out.results = std::move(outcome.results);
+        out.bestSeqIdx = outcome.bestSeqIdx;
+        out.bestScore = outcome.bestScore;
+        out.bestShuffledDeck = outcome.bestShuffledDeck;
+        if (save_shard_result(cfg.outPath, out)) {
+            std::cout << "\n\nShard " << cfg.shardIndex << "/" << cfg.shardCount
+                      << " results written to " << cfg.outPath;
+        } else {
+            std::cerr << "\nwarning: failed to write results " << cfg.outPath << "\n";
+        }
+    }
+
+    if (cfg.bootstrap > 0) print_bootstrap(cfg, outcome.bootstrap, allowed.size(), 10);
+    if (keeps_rankings()) print_rankings(cfg, outcome.rankings, allowed.size());
+    if (permutations) print_pool_check(cfg, check_pool(outcome.bestSeqIdx));
+    if (cfg.stratify) print_stratify_check(cfg, check_stratify(outcome.bestSeqIdx));
+    if (exactPrefixes) print_exact_prefixes(cfg, exactPrefixes->tracked());
+
+    print_experiment_results(cfg, outcome.bestShuffledDeck, outcome.bestSeqIdx, allowed.size());
 }
 
+// Combine shard result files into the global ranking and best sequence
+bool ExperimentRunner::merge(const std::vector<std::string>& shardPaths, std::string& err) {
+    const int base = static_cast<int>(allowed.size());
 
+    std::vector<ShardResult> shards(shardPaths.size());
+    for (std::size_t i = 0; i < shardPaths.size(); ++i) {
+        if (!load_shard_result(shardPaths[i], shards[i])) {
+            err = "could not read shard file " + shardPaths[i];
+            return false;
+        }
+    }
+
+    ShardResult merged;
+    if (!merge_shard_results(shards, base, merged, err)) return false;
+
+    // The shards' experiment with this run's weights and rankings
+    const ExperimentConfig settings = cfg;
+    cfg = merged.cfg;
+    cfg.weights = settings.weights;
+    cfg.reweights = settings.reweights;
+    cfg.top = settings.top;
+    if (!weights_valid(cfg)) {
+        err = "--weights must give a test the shards ran a weight above 0";
+        return false;
+    }
+
+    // Result files keep every statistic, so scores are recomputed rather than trusted -
+    // --weights reranks a finished sweep without simulating it again
+    for (SequenceResult& r : merged.results) {
+        r.score = score(r.uniformity, r.adjacency, r.displacement, r.poker);
+    }
+    std::sort(merged.results.begin(), merged.results.end(), [](const SequenceResult& a, const SequenceResult& b) {
+        return a.score != b.score ? a.score < b.score : a.rank < b.rank;
+    });
+    if (!merged.results.empty()) {
+        const SequenceResult& best = merged.results.front();
+        if (merged.bestSeqIdx.empty() || best.rank != sequence_rank(merged.bestSeqIdx, base)) {
+            merged.bestSeqIdx = sequence_from_rank(best.rank, cfg.kMax, base);
+            merged.bestShuffledDeck = DeckContext{};
+            evaluate_sequence(merged.bestShuffledDeck, merged.bestSeqIdx); // only the new best is replayed
+        }
+        merged.bestScore = best.score;
+    }
+
+    print_experiment_overview(cfg, base);
+    std::cout << "\nMerged                : " << shards.size() << " shards";
+
+    print_ranking(merged.results, cfg.kMax, base, 10);
+    if (keeps_rankings()) {
+        RankingTracker tracker(cfg.top);
+        for (const SequenceResult& r : merged.results) tracker.offer(r);
+        Rankings rankings = tracker.rankings();
+        reweigh(rankings);
+        print_rankings(cfg, rankings, base);
+    }
+    print_experiment_results(cfg, merged.bestShuffledDeck, merged.bestSeqIdx, base);
+    return true;
+}
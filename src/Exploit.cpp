@@ -0,0 +1,503 @@
+#include "Exploit.h"
+#include "DeckUtils.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+
+// ===== Card Tracking =====
+
+// The proposal is fitted by the cross-entropy method: pilot trials run under the
+// current proposal, the tenth that came closest to the event are kept, and each step's
+// tables are refitted to the draws those trials made, weighted by their likelihood
+// ratios. Once a pilot has enough actual hits it is fitted to those alone - the best
+// proposal of this form, as the tables cannot see the deck - and after a couple of such
+// fits (or once a tenth of a pilot hits) the final proposal samples the estimate. If the
+// pilots never get there the fit is not trusted and the estimate is plain Monte Carlo:
+// a proposal fitted to near misses can starve the draws most hits come from. Events a
+// tenth of the first pilot already hits are not tilted at all. A fitted proposal is then
+// checked on one more pilot, and kept only if its estimated variance per trial is below
+// plain Monte Carlo's at that probability - a tilt towards the wrong draws gives fewer,
+// heavier hits - and the estimate falls back to plain Monte Carlo if its own variance
+// turns out no lower. A share of the model is mixed into every proposal, so no draw's
+// ratio exceeds 1 / DEFENSIVE_SHARE however far the fit strays.
+
+namespace {
+
+using TrackEvent = ExperimentRunner::TrackEvent;
+using Positions = std::array<uint8_t, DECK_SIZE>; // card -> position
+
+constexpr int CE_ROUNDS_MAX = 8;
+constexpr int CE_STALL_ROUNDS = 3;      // rounds without a closer level before giving up
+constexpr int CE_HIT_FITS = 2;          // refits to actual hits before sampling the estimate
+constexpr uint64_t CE_HITS_MIN = 50;    // hits a pilot needs to be fitted to them alone
+constexpr double CE_ELITE = 0.1;        // share of pilot trials the proposal is refitted to
+constexpr double CE_SMOOTHING = 0.7;    // weight of the refit against the previous proposal
+constexpr double DEFENSIVE_SHARE = 0.1; // model share of every proposal
+constexpr uint32_t PROPOSAL_TOTAL = 1u << 24;
+// Packet sizes drawn many times per shuffle each move little, and tilting them would
+// multiply many noisy ratios together - they are drawn from the model
+constexpr std::array<bool, MODEL_TABLES> TILTED = {true, true, true, true, false, true, false};
+// Cut points, proposed relative to the tracked card: an offset decides where a cut moves
+// the card whatever position it starts from
+constexpr std::array<bool, MODEL_TABLES> RELATIVE = {true, true, false, true, false, true, false};
+constexpr std::size_t CHUNKS = 64; // fixed split of the trials, so results do not depend on threads
+constexpr uint64_t EXPLOIT_SEED_MIX = 0xD1B54A32D192ED03ull; // tracking streams != sweep streams
+
+// splitmix64 finaliser
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Positions apart, around the deck when it wraps - a final cut rotates it, so there the
+// top and bottom are one cut point from each other; after any other shuffle they are 51 apart
+int apart(int a, int b, bool wraps) {
+    const int d = std::abs(a - b);
+    return wraps ? std::min(d, DECK_SIZE - d) : d;
+}
+
+// How far a deck is from the event, 0 exactly when it happened - pilot rounds pull the
+// proposal towards the closest trials until the event itself is common
+int distance(const TrackEvent& e, const Positions& pos, int seats, bool wraps) {
+    const int p = pos[e.card];
+    switch (e.kind) {
+        case TrackEvent::Kind::Position:
+            if (p >= e.lo && p <= e.hi) return 0;
+            return std::min(apart(p, e.lo, wraps), apart(p, e.hi, wraps));
+        case TrackEvent::Kind::Seat:
+            return std::min(apart(p, e.lo, wraps), apart(p, seats + e.lo, wraps)); // hole cards: seat, seats + seat
+        case TrackEvent::Kind::Pair:
+            if (std::abs(p - pos[e.other]) <= e.lo) return 0;
+            return std::max(1, apart(p, pos[e.other], wraps) - e.lo);
+    }
+    return 0;
+}
+
+using Probs = std::array<double, DECK_SIZE>;
+
+Probs model_probs(const CdfTable& cdf) {
+    Probs p{};
+    for (int x = 0; x < DECK_SIZE; ++x) p[x] = static_cast<double>(cdf[x] - (x > 0 ? cdf[x - 1] : 0)) / cdf[DECK_SIZE - 1];
+    return p;
+}
+
+// Samplable form of a value table's fitted proposal, mixed with the model on its support
+void make_samplable(const CdfTable& table, SampleTilt::Proposal& out) {
+    const Probs p = model_probs(table);
+    const Probs& q = out.probs;
+
+    uint32_t running = 0;
+    std::array<uint32_t, DECK_SIZE> weight{};
+    for (int x = 0; x < DECK_SIZE; ++x) {
+        if (p[x] > 0) {
+            const double mixed = (1 - DEFENSIVE_SHARE) * q[x] + DEFENSIVE_SHARE * p[x];
+            weight[x] = std::max<uint32_t>(1, static_cast<uint32_t>(std::llround(mixed * PROPOSAL_TOTAL)));
+        }
+        running += weight[x];
+        out.cdf[x] = running;
+    }
+    for (int x = 0; x < DECK_SIZE; ++x) {
+        out.logRatio[x] = weight[x] > 0 ? std::log(p[x]) - std::log(static_cast<double>(weight[x]) / running) : 0;
+    }
+}
+
+// One draw from fitted (over values, renormalised on the model's support p > 0) mixed
+// with the model, for proposals that depend on the deck and so are built per draw;
+// adds the draw's log(model / proposal) to logWeight
+int mixed_draw(PCG32& rng, const Probs& p, const Probs& fitted, double& logWeight) {
+    double onSupport = 0;
+    for (int x = 0; x < DECK_SIZE; ++x) {
+        if (p[x] > 0) onSupport += fitted[x];
+    }
+    Probs cum{};
+    double running = 0;
+    for (int x = 0; x < DECK_SIZE; ++x) {
+        if (p[x] > 0) running += (1 - DEFENSIVE_SHARE) * (onSupport > 0 ? fitted[x] / onSupport : p[x]) + DEFENSIVE_SHARE * p[x];
+        cum[x] = running;
+    }
+    const double u = (rng.random_bounded(1u << 30) + 0.5) / (1u << 30) * running;
+    int v = 0;
+    while (v < DECK_SIZE - 1 && (cum[v] <= u || p[v] == 0)) ++v;
+    logWeight += std::log(p[v]) - std::log((cum[v] - (v > 0 ? cum[v - 1] : 0)) / running);
+    return v;
+}
+
+// Model distribution of where a riffle lands the card r-th from the top of its packet of
+// size own, the other packet holding other cards: every interleaving is equally likely, so
+// landing at k leaves r of its packet's cards among the k above it and the rest below
+Probs landing_probs(int r, int own, int other) {
+    auto logChoose = [](int n, int k) { return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0); };
+    Probs p{};
+    const double all = logChoose(DECK_SIZE, own);
+    for (int k = r; k <= r + other; ++k) {
+        p[k] = std::exp(logChoose(k, r) + logChoose(DECK_SIZE - 1 - k, own - 1 - r) - all);
+    }
+    return p;
+}
+
+bool parse_card(const std::string& s, int& card) {
+    if (!s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        if (s.size() > 2) return false;
+        card = std::stoi(s);
+        return card < DECK_SIZE;
+    }
+    if (s.size() != 2) return false;
+
+    static constexpr std::string_view RANKS = "A23456789TJQK";
+    static constexpr std::string_view SUITS = "cdhs"; // Suit order
+    const auto rank = RANKS.find(static_cast<char>(std::toupper(static_cast<unsigned char>(s[0]))));
+    const auto suit = SUITS.find(static_cast<char>(std::tolower(static_cast<unsigned char>(s[1]))));
+    if (rank == std::string_view::npos || suit == std::string_view::npos) return false;
+    card = static_cast<int>(suit * 13 + rank);
+    return true;
+}
+
+bool parse_int(const std::string& s, int lo, int hi, int& out) {
+    if (s.empty() || s.size() > 3 || !std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; })) return false;
+    out = std::stoi(s);
+    return out >= lo && out <= hi;
+}
+
+} // namespace
+
+// Draw from the current step's proposal for table, accumulating its likelihood ratio
+uint8_t DeckContext::tilted_sample(ModelTable table, const CdfTable& cdf) noexcept {
+    const int t = static_cast<int>(table);
+    if (!TILTED[t]) return rng.sample_cdf(cdf);
+
+    const SampleTilt::Proposal& q = tilt->proposals[tilt->step][t];
+    int anchor = 0;
+    if (RELATIVE[t]) {
+        while (deck[anchor] != tilt->card) ++anchor;
+    }
+
+    int v = 0;
+    if (!q.fitted) {
+        v = rng.sample_cdf(cdf);
+    } else if (RELATIVE[t]) {
+        // Offsets from the card mapped onto this deck's values - built per draw, as the card moves
+        Probs fitted{};
+        for (int x = 0; x < DECK_SIZE; ++x) fitted[x] = q.probs[(x - anchor + DECK_SIZE) % DECK_SIZE];
+        v = mixed_draw(rng, model_probs(cdf), fitted, tilt->logWeight);
+    } else {
+        const uint32_t r = rng.random_bounded(q.cdf[DECK_SIZE - 1]);
+        while (r >= q.cdf[v]) ++v;
+        tilt->logWeight += q.logRatio[v];
+    }
+
+    if (tilt->record) {
+        const int value = RELATIVE[t] ? (v - anchor + DECK_SIZE) % DECK_SIZE : v;
+        tilt->draws.push_back({static_cast<uint8_t>(tilt->step), static_cast<uint8_t>(t), static_cast<uint8_t>(value)});
+    }
+    return static_cast<uint8_t>(v);
+}
+
+// GSR interleave of [0, cutPoint) and [cutPoint, DECK_SIZE) as DeckContext::riffle, drawn
+// in two parts: the tracked card's landing position (from the step's proposal), then a
+// uniform interleave of the cards above it and of those below it
+void DeckContext::tilted_interleave(int cutPoint) noexcept {
+    int anchor = 0;
+    while (deck[anchor] != tilt->card) ++anchor;
+
+    const bool inLeft = anchor < cutPoint;
+    const int own = inLeft ? cutPoint : DECK_SIZE - cutPoint; // the card's packet
+    const int r = inLeft ? anchor : anchor - cutPoint;        // cards above it in its packet
+    const Probs p = landing_probs(r, own, DECK_SIZE - own);
+
+    const SampleTilt::Proposal& q = tilt->proposals[tilt->step][SampleTilt::LANDING];
+    int k = 0;
+    if (q.fitted) {
+        k = mixed_draw(rng, p, q.probs, tilt->logWeight);
+    } else {
+        const double u = (rng.random_bounded(1u << 30) + 0.5) / (1u << 30);
+        double running = 0;
+        while (k < DECK_SIZE - 1 && (running += p[k]) <= u) ++k;
+    }
+    if (tilt->record) {
+        tilt->draws.push_back({static_cast<uint8_t>(tilt->step), static_cast<uint8_t>(SampleTilt::LANDING), static_cast<uint8_t>(k)});
+    }
+
+    // Packets top down: next[0] left, next[1] right; the card's own packet is split at it
+    int next[2] = {0, cutPoint};
+    const int end[2] = {cutPoint, DECK_SIZE};
+    const int ownSide = inLeft ? 0 : 1;
+    auto interleave = [&](int from, int to, int ownCards, int otherCards) {
+        for (int i = from; i < to; ++i) {
+            const bool takeOwn = rng.random_bounded(ownCards + otherCards) < static_cast<uint32_t>(ownCards);
+            const int side = takeOwn ? ownSide : 1 - ownSide;
+            (takeOwn ? ownCards : otherCards)--;
+            buffer[i] = deck[next[side]++];
+        }
+    };
+    interleave(0, k, r, k - r);
+    buffer[k] = deck[next[ownSide]++];
+    interleave(k + 1, DECK_SIZE, end[ownSide] - next[ownSide], end[1 - ownSide] - next[1 - ownSide]);
+    deck = buffer;
+}
+
+bool parse_track_event(const std::string& spec, TrackEvent& out, std::string& err) {
+    std::vector<std::string> parts;
+    std::size_t start = 0;
+    while (start <= spec.size()) {
+        const std::size_t colon = std::min(spec.find(':', start), spec.size());
+        parts.push_back(spec.substr(start, colon - start));
+        start = colon + 1;
+    }
+
+    const std::string& kind = parts[0];
+    if (kind == "pos" && parts.size() == 3) {
+        out.kind = TrackEvent::Kind::Position;
+        const auto dash = parts[2].find('-');
+        const std::string lo = parts[2].substr(0, dash);
+        const std::string hi = dash == std::string::npos ? lo : parts[2].substr(dash + 1);
+        if (!parse_card(parts[1], out.card) || !parse_int(lo, 0, DECK_SIZE - 1, out.lo) ||
+            !parse_int(hi, out.lo, DECK_SIZE - 1, out.hi)) {
+            err = "pos events are pos:<card>:<lo>-<hi>, positions 0 (top) to 51, e.g. pos:Ks:47-51";
+            return false;
+        }
+        return true;
+    }
+    if (kind == "seat" && parts.size() == 3) {
+        out.kind = TrackEvent::Kind::Seat;
+        int seat = 0;
+        if (!parse_card(parts[1], out.card) || !parse_int(parts[2], 1, POKER_MAX_SEATS, seat)) {
+            err = "seat events are seat:<card>:<seat>, seats from 1, e.g. seat:As:1";
+            return false;
+        }
+        out.lo = seat - 1;
+        return true;
+    }
+    if (kind == "pair" && (parts.size() == 3 || parts.size() == 4)) {
+        out.kind = TrackEvent::Kind::Pair;
+        out.lo = 1;
+        if (!parse_card(parts[1], out.card) || !parse_card(parts[2], out.other) || out.card == out.other ||
+            (parts.size() == 4 && !parse_int(parts[3], 1, DECK_SIZE - 1, out.lo))) {
+            err = "pair events are pair:<card>:<card>[:<within>], two different cards, e.g. pair:As:Ah";
+            return false;
+        }
+        return true;
+    }
+
+    err = "--track expects pos:<card>:<lo>-<hi>, seat:<card>:<seat> or pair:<card>:<card>[:<within>]";
+    return false;
+}
+
+std::string track_to_string(const TrackEvent& e) {
+    const std::string card = card_to_string(static_cast<Card>(e.card));
+    switch (e.kind) {
+        case TrackEvent::Kind::Position:
+            if (e.lo == e.hi) return card + " at position " + std::to_string(e.lo);
+            return card + " in positions " + std::to_string(e.lo) + "-" + std::to_string(e.hi);
+        case TrackEvent::Kind::Seat:
+            return card + " dealt to seat " + std::to_string(e.lo + 1);
+        case TrackEvent::Kind::Pair:
+            return card + " and " + card_to_string(static_cast<Card>(e.other)) +
+                   (e.lo == 1 ? std::string(" adjacent") : " within " + std::to_string(e.lo) + " positions");
+    }
+    return "";
+}
+
+ExperimentRunner::ExploitOutcome ExperimentRunner::exploit() {
+    const std::vector<Shuffle>& seq = cfg.exploitSequence;
+    const int steps = static_cast<int>(seq.size());
+    const std::size_t numEvents = cfg.track.size();
+    const uint64_t trials = static_cast<uint64_t>(cfg.exploitTrials);
+    const uint64_t pilot = std::clamp<uint64_t>(trials / 10, 1000, 20000);
+
+    uint64_t code = 1; // as sequence_code, without going through allowed
+    for (Shuffle s : seq) code = (code << 3) | static_cast<uint64_t>(s);
+    const bool wraps = !seq.empty() && seq.back() == Shuffle::Cut;
+
+    ThreadPool& pool = workers();
+
+    const ShuffleModel& model = default_model();
+
+    // n sorted decks through the sequence (tilted when proposals is given), each handed
+    // to fn(chunk, trial, positions, tilt) - chunks seed their own streams from salt
+    auto simulate = [&](uint64_t n, uint64_t salt, const std::vector<std::array<SampleTilt::Proposal, SampleTilt::SLOTS>>* proposals,
+                        int card, bool record, const auto& fn) {
+        pool.parallel_for(CHUNKS, [&](std::size_t c) {
+            DeckContext ctx;
+            ctx.rng.seed(cfg.seed ^ EXPLOIT_SEED_MIX ^ mix64(salt * CHUNKS + c), code);
+
+            SampleTilt tilt;
+            if (proposals) {
+                tilt.card = card;
+                tilt.proposals = *proposals;
+                tilt.record = record;
+                ctx.tilt = &tilt;
+            }
+
+            Positions pos;
+            for (uint64_t t = n * c / CHUNKS; t < n * (c + 1) / CHUNKS; ++t) {
+                ctx.reset();
+                tilt.begin_trial();
+                for (int s = 0; s < steps; ++s) {
+                    tilt.step = s;
+                    apply_shuffle(ctx, seq[s]);
+                }
+                for (int i = 0; i < DECK_SIZE; ++i) pos[ctx.deck[i]] = static_cast<uint8_t>(i);
+                fn(c, t, pos, tilt);
+            }
+        });
+    };
+
+    ExploitOutcome out;
+    out.trials = trials;
+    out.events.resize(numEvents);
+
+    // Plain Monte Carlo of every event at once, for comparison
+    {
+        std::vector<uint64_t> hits(CHUNKS * numEvents);
+        simulate(trials, 0, nullptr, 0, false, [&](std::size_t c, uint64_t, const Positions& pos, const SampleTilt&) {
+            for (std::size_t e = 0; e < numEvents; ++e) hits[c * numEvents + e] += distance(cfg.track[e], pos, cfg.pokerSeats, wraps) == 0;
+        });
+        for (std::size_t e = 0; e < numEvents; ++e) {
+            for (std::size_t c = 0; c < CHUNKS; ++c) out.events[e].directHits += hits[c * numEvents + e];
+            out.events[e].directProbability = static_cast<double>(out.events[e].directHits) / trials;
+        }
+    }
+
+    for (std::size_t e = 0; e < numEvents; ++e) {
+        const TrackEvent& event = cfg.track[e];
+        ExploitOutcome::Event& result = out.events[e];
+        const uint64_t saltBase = 1 + e * (CE_ROUNDS_MAX + 2); // rounds, estimate, check
+
+        // Proposal starts at the model (unfitted tables draw from it)
+        std::vector<std::array<SampleTilt::Proposal, SampleTilt::SLOTS>> proposals(steps);
+
+        std::vector<int> dist(pilot);
+        std::vector<double> logWeight(pilot);
+        std::vector<std::vector<SampleTilt::Draw>> draws(pilot);
+
+        int bestLevel = DECK_SIZE, stalled = 0, hitFits = 0;
+        for (int round = 0; round < CE_ROUNDS_MAX && stalled < CE_STALL_ROUNDS; ++round) {
+            simulate(pilot, saltBase + round, &proposals, event.card, true, [&](std::size_t, uint64_t t, const Positions& pos, const SampleTilt& tilt) {
+                dist[t] = distance(event, pos, cfg.pokerSeats, wraps);
+                logWeight[t] = tilt.logWeight;
+                draws[t] = tilt.draws;
+            });
+            ++result.rounds;
+            out.pilotTrials += pilot;
+
+            const uint64_t hits = static_cast<uint64_t>(std::count(dist.begin(), dist.end(), 0));
+            if (round == 0 && hits >= CE_ELITE * pilot) break; // not rare - nothing to gain from tilting
+            int level = 0;
+            if (hits < CE_HITS_MIN) {
+                std::vector<int> sorted = dist;
+                std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(CE_ELITE * pilot), sorted.end());
+                level = sorted[static_cast<std::size_t>(CE_ELITE * pilot)];
+            }
+
+            // Refit each step's tables to the elite trials' draws, weighted by their ratios
+            // (relative to the largest, so exp stays in range)
+            double maxLog = -INFINITY;
+            for (uint64_t t = 0; t < pilot; ++t) {
+                if (dist[t] <= level) maxLog = std::max(maxLog, logWeight[t]);
+            }
+            std::vector<std::array<Probs, SampleTilt::SLOTS>> counts(steps);
+            for (uint64_t t = 0; t < pilot; ++t) {
+                if (dist[t] > level) continue;
+                const double w = std::exp(logWeight[t] - maxLog);
+                for (const SampleTilt::Draw& d : draws[t]) counts[d.step][d.table][d.value] += w;
+            }
+            for (int s = 0; s < steps; ++s) {
+                for (int t = 0; t < SampleTilt::SLOTS; ++t) {
+                    double total = 0;
+                    for (double c : counts[s][t]) total += c;
+                    if (!(total > 0)) continue; // table not drawn at this step
+
+                    SampleTilt::Proposal& q = proposals[s][t];
+                    const double keep = q.fitted ? 1 - CE_SMOOTHING : 0;
+                    for (int x = 0; x < DECK_SIZE; ++x) q.probs[x] = (1 - keep) * counts[s][t][x] / total + keep * q.probs[x];
+                    q.fitted = true;
+                    if (t < MODEL_TABLES && !RELATIVE[t]) make_samplable(model.table(static_cast<ModelTable>(t)), q);
+                }
+            }
+
+            result.tilted = level == 0;
+            if (level == 0) {
+                if (++hitFits >= CE_HIT_FITS || hits >= CE_ELITE * pilot) break;
+                continue;
+            }
+            stalled = level < bestLevel ? 0 : stalled + 1;
+            bestLevel = std::min(bestLevel, level);
+        }
+
+        // Check the fit: ratio x hit over one more pilot, against plain Monte Carlo's p (1 - p)
+        if (result.tilted) {
+            std::vector<double> sum(CHUNKS), sumSq(CHUNKS);
+            simulate(pilot, saltBase + CE_ROUNDS_MAX + 1, &proposals, event.card, false, [&](std::size_t c, uint64_t, const Positions& pos, const SampleTilt& tilt) {
+                if (distance(event, pos, cfg.pokerSeats, wraps) != 0) return;
+                const double y = std::exp(tilt.logWeight);
+                sum[c] += y;
+                sumSq[c] += y * y;
+            });
+            out.pilotTrials += pilot;
+
+            double total = 0, totalSq = 0;
+            for (std::size_t c = 0; c < CHUNKS; ++c) {
+                total += sum[c];
+                totalSq += sumSq[c];
+            }
+            const double n = static_cast<double>(pilot);
+            const double mean = total / n;
+            if (!(mean > 0) || totalSq / n - mean * mean >= mean * (1 - mean)) {
+                result.tilted = false;
+                result.rejected = true;
+            }
+        }
+
+        // Estimate: mean of ratio x hit, summed per chunk then in chunk order
+        std::vector<double> sum(CHUNKS), sumSq(CHUNKS);
+        std::vector<uint64_t> hits(CHUNKS);
+        simulate(trials, saltBase + CE_ROUNDS_MAX, result.tilted ? &proposals : nullptr, event.card, false, [&](std::size_t c, uint64_t, const Positions& pos, const SampleTilt& tilt) {
+            if (distance(event, pos, cfg.pokerSeats, wraps) != 0) return;
+            const double y = std::exp(tilt.logWeight);
+            sum[c] += y;
+            sumSq[c] += y * y;
+            ++hits[c];
+        });
+
+        double total = 0, totalSq = 0;
+        for (std::size_t c = 0; c < CHUNKS; ++c) {
+            total += sum[c];
+            totalSq += sumSq[c];
+            result.hits += hits[c];
+        }
+        const double n = static_cast<double>(trials);
+        const double mean = total / n;
+        const double variance = trials > 1 ? std::max(0.0, (totalSq / n - mean * mean) * n / (n - 1)) : 0;
+        const double se = std::sqrt(variance / n);
+
+        result.probability = mean;
+        result.low = std::max(0.0, mean - 1.96 * se);
+        result.high = std::min(1.0, mean + 1.96 * se);
+        result.ess = totalSq > 0 ? total * total / totalSq : 0;
+        result.plainTrials = se > 0 ? mean * (1 - mean) / (se * se) : 0;
+
+        // A heavy-tailed fit can pass the check on a lucky pilot; if the estimate itself
+        // varies no less than plain Monte Carlo would, the plain run above is reported
+        if (result.tilted && result.plainTrials <= n) {
+            const double p = result.directProbability;
+            const double plainSe = std::sqrt(p * (1 - p) / n);
+            result.tilted = false;
+            result.rejected = true;
+            result.probability = p;
+            result.low = std::max(0.0, p - 1.96 * plainSe);
+            result.high = std::min(1.0, p + 1.96 * plainSe);
+            result.hits = result.directHits;
+            result.ess = static_cast<double>(result.directHits);
+            result.plainTrials = plainSe > 0 ? n : 0;
+        }
+    }
+
+    return out;
+}
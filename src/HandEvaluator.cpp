@@ -0,0 +1,190 @@
+#include "HandEvaluator.h"
+
+#include <algorithm>
+#include <bit>
+#include <initializer_list>
+#include <vector>
+
+namespace {
+
+constexpr int RANKS = 13;
+constexpr int HAND_CARDS = 7;
+constexpr int MAX_PER_RANK = 4;
+constexpr int NONFLUSH_KEYS = 49205; // rank-count vectors of 7 cards, at most 4 per rank
+
+// Deck card -> evaluator rank (deck has ace = 0, evaluator deuce = 0 .. ace = 12)
+constexpr std::array<uint8_t, DECK_SIZE> CARD_RANK = []{
+    std::array<uint8_t, DECK_SIZE> r{};
+    for (int c = 0; c < DECK_SIZE; ++c) r[c] = static_cast<uint8_t>((c % RANKS + RANKS - 1) % RANKS);
+    return r;
+}();
+
+// Raw comparable value: class << 20, then up to five 4-bit ranks, most significant first
+uint32_t pack(HandClass cls, std::initializer_list<int> ranks) {
+    uint32_t v = static_cast<uint32_t>(cls) << 20;
+    int shift = 16;
+    for (int r : ranks) {
+        v |= static_cast<uint32_t>(r) << shift;
+        shift -= 4;
+    }
+    return v;
+}
+
+// Highest straight in a rank mask (3 = five-high wheel), -1 if none
+int straight_high(uint32_t mask) {
+    for (int hi = RANKS - 1; hi >= 4; --hi) {
+        if (((mask >> (hi - 4)) & 0x1F) == 0x1F) return hi;
+    }
+    if ((mask & 0x100F) == 0x100F) return 3; // A-2-3-4-5
+    return -1;
+}
+
+// Ranks of mask in descending order, skipping up to two excluded ranks
+std::vector<int> top_ranks(uint32_t mask, int n, int skipA = -1, int skipB = -1) {
+    std::vector<int> out;
+    for (int r = RANKS - 1; r >= 0 && static_cast<int>(out.size()) < n; --r) {
+        if ((mask >> r & 1) && r != skipA && r != skipB) out.push_back(r);
+    }
+    return out;
+}
+
+uint32_t flush_value(uint32_t mask) {
+    const int sh = straight_high(mask);
+    if (sh >= 0) return pack(StraightFlush, {sh});
+    const auto t = top_ranks(mask, 5);
+    return pack(Flush, {t[0], t[1], t[2], t[3], t[4]});
+}
+
+uint32_t nonflush_value(const std::array<uint8_t, RANKS>& count) {
+    uint32_t mask = 0;
+    int quad = -1;
+    std::vector<int> trips, pairs; // descending
+    for (int r = RANKS - 1; r >= 0; --r) {
+        if (count[r] > 0) mask |= 1u << r;
+        if (count[r] == 4) quad = r;
+        else if (count[r] == 3) trips.push_back(r);
+        else if (count[r] == 2) pairs.push_back(r);
+    }
+
+    if (quad >= 0) {
+        return pack(Quads, {quad, top_ranks(mask, 1, quad)[0]});
+    }
+    if (!trips.empty() && (trips.size() >= 2 || !pairs.empty())) {
+        const int pair = std::max(trips.size() >= 2 ? trips[1] : -1, pairs.empty() ? -1 : pairs[0]);
+        return pack(FullHouse, {trips[0], pair});
+    }
+    const int sh = straight_high(mask);
+    if (sh >= 0) return pack(Straight, {sh});
+    if (!trips.empty()) {
+        const auto k = top_ranks(mask, 2, trips[0]);
+        return pack(Trips, {trips[0], k[0], k[1]});
+    }
+    if (pairs.size() >= 2) {
+        return pack(TwoPair, {pairs[0], pairs[1], top_ranks(mask, 1, pairs[0], pairs[1])[0]});
+    }
+    if (pairs.size() == 1) {
+        const auto k = top_ranks(mask, 3, pairs[0]);
+        return pack(OnePair, {pairs[0], k[0], k[1], k[2]});
+    }
+    const auto k = top_ranks(mask, 5);
+    return pack(HighCard, {k[0], k[1], k[2], k[3], k[4]});
+}
+
+struct Tables {
+    // offset[r][k][c]: hash contribution of c cards at rank r with k cards left to place
+    uint16_t offset[RANKS][HAND_CARDS + 1][MAX_PER_RANK + 1] = {};
+    std::vector<HandStrength> nonflush = std::vector<HandStrength>(NONFLUSH_KEYS);
+    std::vector<HandStrength> flush = std::vector<HandStrength>(1u << RANKS);
+    std::vector<uint8_t> handClass; // by strength
+};
+
+const Tables TABLES = []{
+    Tables t;
+
+    // ways[n][k]: count vectors over n ranks summing to k
+    uint32_t ways[RANKS + 1][HAND_CARDS + 1] = {};
+    ways[0][0] = 1;
+    for (int n = 1; n <= RANKS; ++n) {
+        for (int k = 0; k <= HAND_CARDS; ++k) {
+            for (int v = 0; v <= std::min(MAX_PER_RANK, k); ++v) ways[n][k] += ways[n - 1][k - v];
+        }
+    }
+    for (int r = 0; r < RANKS; ++r) {
+        for (int k = 0; k <= HAND_CARDS; ++k) {
+            uint32_t acc = 0;
+            for (int c = 0; c <= MAX_PER_RANK; ++c) {
+                t.offset[r][k][c] = static_cast<uint16_t>(acc);
+                if (c <= k) acc += ways[RANKS - 1 - r][k - c];
+            }
+        }
+    }
+
+    // Raw values first, then compress to dense strengths
+    std::vector<uint32_t> rawNonflush(NONFLUSH_KEYS), rawFlush(1u << RANKS, 0);
+    std::array<uint8_t, RANKS> count{};
+    auto fill = [&](auto&& self, int r, int left, uint32_t key) -> void {
+        if (r == RANKS) {
+            if (left == 0) rawNonflush[key] = nonflush_value(count);
+            return;
+        }
+        for (int c = 0; c <= std::min(MAX_PER_RANK, left); ++c) {
+            count[r] = static_cast<uint8_t>(c);
+            self(self, r + 1, left - c, key + t.offset[r][left][c]);
+        }
+        count[r] = 0;
+    };
+    fill(fill, 0, HAND_CARDS, 0);
+
+    std::vector<uint32_t> all(rawNonflush);
+    for (uint32_t mask = 0; mask < (1u << RANKS); ++mask) {
+        const int n = std::popcount(mask);
+        if (n < 5 || n > HAND_CARDS) continue;
+        rawFlush[mask] = flush_value(mask);
+        all.push_back(rawFlush[mask]);
+    }
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end()); // 4824 distinct best-of-7 hands
+
+    auto strength = [&](uint32_t raw) {
+        return static_cast<HandStrength>(std::lower_bound(all.begin(), all.end(), raw) - all.begin());
+    };
+    for (int key = 0; key < NONFLUSH_KEYS; ++key) t.nonflush[key] = strength(rawNonflush[key]);
+    for (uint32_t mask = 0; mask < (1u << RANKS); ++mask) {
+        if (rawFlush[mask]) t.flush[mask] = strength(rawFlush[mask]);
+    }
+    t.handClass.resize(all.size());
+    for (std::size_t s = 0; s < all.size(); ++s) t.handClass[s] = static_cast<uint8_t>(all[s] >> 20);
+
+    return t;
+}();
+
+} // namespace
+
+void PartialHand::add(Card c) noexcept {
+    const uint8_t r = CARD_RANK[c];
+    ++count[r];
+    suitMask[c / RANKS] |= static_cast<uint16_t>(1u << r);
+}
+
+HandStrength PartialHand::evaluate() const noexcept {
+    for (uint16_t m : suitMask) {
+        if (std::popcount(m) >= 5) return TABLES.flush[m];
+    }
+    uint32_t key = 0;
+    int left = HAND_CARDS;
+    for (int r = 0; r < RANKS; ++r) {
+        key += TABLES.offset[r][left][count[r]];
+        left -= count[r];
+    }
+    return TABLES.nonflush[key];
+}
+
+HandStrength evaluate_7(const Card* cards) noexcept {
+    PartialHand h;
+    for (int i = 0; i < HAND_CARDS; ++i) h.add(cards[i]);
+    return h.evaluate();
+}
+
+HandClass hand_class(HandStrength s) noexcept {
+    return static_cast<HandClass>(TABLES.handClass[s]);
+}
@@ -0,0 +1,219 @@
+#include "Json.h"
+
+#include <cctype>
+#include <cstdio>  // snprintf
+#include <cstdlib> // strtod
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type != Type::Object) return nullptr;
+    for (const auto& [k, v] : object) {
+        if (k == key) return &v;
+    }
+    return nullptr;
+}
+
+double JsonValue::number_or(const std::string& key, double fallback) const {
+    const JsonValue* v = find(key);
+    return (v && v->is_number()) ? v->number : fallback;
+}
+
+std::string JsonValue::string_or(const std::string& key, const std::string& fallback) const {
+    const JsonValue* v = find(key);
+    return (v && v->is_string()) ? v->string : fallback;
+}
+
+// ----- Parser (recursive descent) -----
+
+namespace {
+
+struct Parser {
+    const std::string& s;
+    std::size_t pos = 0;
+    std::string err;
+    int depth = 0;
+
+    explicit Parser(const std::string& text) : s(text) {}
+
+    void skip_ws() {
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) ++pos;
+    }
+
+    bool fail(const std::string& msg) {
+        if (err.empty()) err = msg + " at offset " + std::to_string(pos);
+        return false;
+    }
+
+    bool literal(const char* word) {
+        std::size_t n = std::char_traits<char>::length(word);
+        if (s.compare(pos, n, word) != 0) return fail("invalid literal");
+        pos += n;
+        return true;
+    }
+
+    bool parse_string(std::string& out) {
+        if (s[pos] != '"') return fail("expected string");
+        ++pos;
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= s.size()) break;
+            char e = s[pos++];
+            switch (e) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': { // BMP only, encoded as UTF-8
+                    if (pos + 4 > s.size()) return fail("bad \\u escape");
+                    unsigned cp = std::strtoul(s.substr(pos, 4).c_str(), nullptr, 16);
+                    pos += 4;
+                    if (cp < 0x80) {
+                        out += static_cast<char>(cp);
+                    } else if (cp < 0x800) {
+                        out += static_cast<char>(0xC0 | (cp >> 6));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (cp >> 12));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: return fail("bad escape");
+            }
+        }
+        if (pos >= s.size()) return fail("unterminated string");
+        ++pos; // closing quote
+        return true;
+    }
+
+    bool parse_value(JsonValue& v) {
+        if (++depth > 64) return fail("nesting too deep");
+        skip_ws();
+        if (pos >= s.size()) return fail("unexpected end");
+
+        bool ok = true;
+        char c = s[pos];
+        if (c == '{') {
+            v.type = JsonValue::Type::Object;
+            ++pos;
+            skip_ws();
+            if (pos < s.size() && s[pos] == '}') {
+                ++pos;
+            } else {
+                for (;;) {
+                    skip_ws();
+                    std::string key;
+                    if (pos >= s.size() || !parse_string(key)) { ok = fail("expected key"); break; }
+                    skip_ws();
+                    if (pos >= s.size() || s[pos] != ':') { ok = fail("expected ':'"); break; }
+                    ++pos;
+                    JsonValue item;
+                    if (!parse_value(item)) { ok = false; break; }
+                    v.object.emplace_back(std::move(key), std::move(item));
+                    skip_ws();
+                    if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                    if (pos < s.size() && s[pos] == '}') { ++pos; break; }
+                    ok = fail("expected ',' or '}'");
+                    break;
+                }
+            }
+        }
+        else if (c == '[') {
+            v.type = JsonValue::Type::Array;
+            ++pos;
+            skip_ws();
+            if (pos < s.size() && s[pos] == ']') {
+                ++pos;
+            } else {
+                for (;;) {
+                    JsonValue item;
+                    if (!parse_value(item)) { ok = false; break; }
+                    v.array.push_back(std::move(item));
+                    skip_ws();
+                    if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                    if (pos < s.size() && s[pos] == ']') { ++pos; break; }
+                    ok = fail("expected ',' or ']'");
+                    break;
+                }
+            }
+        }
+        else if (c == '"') {
+            v.type = JsonValue::Type::String;
+            ok = parse_string(v.string);
+        }
+        else if (c == 't') {
+            v.type = JsonValue::Type::Bool;
+            v.boolean = true;
+            ok = literal("true");
+        }
+        else if (c == 'f') {
+            v.type = JsonValue::Type::Bool;
+            ok = literal("false");
+        }
+        else if (c == 'n') {
+            ok = literal("null");
+        }
+        else {
+            const char* begin = s.c_str() + pos;
+            char* stop = nullptr;
+            v.number = std::strtod(begin, &stop);
+            if (stop == begin) {
+                ok = fail("unexpected character");
+            } else {
+                v.type = JsonValue::Type::Number;
+                pos += stop - begin;
+            }
+        }
+
+        --depth;
+        return ok;
+    }
+};
+
+} // namespace
+
+bool parse_json(const std::string& text, JsonValue& out, std::string& err) {
+    Parser p(text);
+    out = JsonValue{};
+    if (!p.parse_value(out)) {
+        err = p.err;
+        return false;
+    }
+    p.skip_ws();
+    if (p.pos != text.size()) {
+        err = "trailing characters at offset " + std::to_string(p.pos);
+        return false;
+    }
+    return true;
+}
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
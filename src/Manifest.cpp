@@ -0,0 +1,267 @@
+#include "Manifest.h"
+#include "Json.h"
+#include "ResultCache.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// Whole number in [lo, hi]
+bool get_int(const JsonValue& v, int lo, int hi, int& out) {
+    if (!v.is_number() || v.number != std::floor(v.number) || v.number < lo || v.number > hi) return false;
+    out = static_cast<int>(v.number);
+    return true;
+}
+
+// A number (exact up to 2^53) or a string of digits for larger seeds
+bool get_seed(const JsonValue& v, uint64_t& out) {
+    if (v.is_number()) {
+        if (v.number != std::floor(v.number) || v.number < 0 || v.number > 9007199254740992.0) return false;
+        out = static_cast<uint64_t>(v.number);
+        return true;
+    }
+    if (!v.is_string() || v.string.empty() || v.string.size() > 20) return false;
+    for (char c : v.string) {
+        if (c < '0' || c > '9') return false;
+    }
+    try {
+        out = std::stoull(v.string);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool apply_experiment_keys(const JsonValue& obj, ExperimentRunner::ExperimentConfig& cfg, std::string& name, bool& sawSeed, std::string& err) {
+    if (!obj.is_object()) {
+        err = "experiments and defaults must be objects";
+        return false;
+    }
+
+    for (const auto& [key, v] : obj.object) {
+        auto fail = [&](const std::string& expected) {
+            err = "\"" + key + "\" must be " + expected;
+            return false;
+        };
+
+        if (key == "name") {
+            if (!v.is_string()) return fail("a string");
+            name = v.string;
+        }
+        else if (key == "k") {
+            if (!get_int(v, ExperimentRunner::K_MIN, ExperimentRunner::K_MAX, cfg.kMax))
+                return fail("between " + std::to_string(ExperimentRunner::K_MIN) + " and " + std::to_string(ExperimentRunner::K_MAX));
+        }
+        else if (key == "trials") {
+            if (!get_int(v, 1, ExperimentRunner::TRIAL_MAX, cfg.trials))
+                return fail("between 1 and " + std::to_string(ExperimentRunner::TRIAL_MAX));
+        }
+        else if (key == "seed") {
+            if (!get_seed(v, cfg.seed)) return fail("a whole number (a string of digits above 2^53)");
+            sawSeed = true;
+        }
+        else if (key == "tests") {
+            if (!v.is_array() || v.array.empty()) return fail("a list of uniformity, adjacency, mixing or poker");
+            cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = cfg.testPoker = false;
+            for (const JsonValue& t : v.array) {
+                if (t.is_string() && t.string == "uniformity")     cfg.testUniformity = true;
+                else if (t.is_string() && t.string == "adjacency") cfg.testAdjacency = true;
+                else if (t.is_string() && t.string == "mixing")    cfg.testMixing = true;
+                else if (t.is_string() && t.string == "poker")     cfg.testPoker = true;
+                else return fail("a list of uniformity, adjacency, mixing or poker");
+            }
+        }
+        else if (key == "seats") {
+            if (!get_int(v, 2, POKER_MAX_SEATS, cfg.pokerSeats)) return fail("between 2 and " + std::to_string(POKER_MAX_SEATS));
+        }
+        else if (key == "stream") {
+            if (!get_int(v, 0, ExperimentRunner::STREAM_HANDS_MAX, cfg.streamHands))
+                return fail("between 0 (off) and " + std::to_string(ExperimentRunner::STREAM_HANDS_MAX));
+        }
+        else if (key == "warmup") {
+            if (!get_int(v, 0, ExperimentRunner::STREAM_HANDS_MAX, cfg.streamWarmup))
+                return fail("between 0 and " + std::to_string(ExperimentRunner::STREAM_HANDS_MAX));
+        }
+        else if (key == "collect") {
+            if (v.is_string() && v.string == "sorted")     cfg.collect = CollectModel::Sorted;
+            else if (v.is_string() && v.string == "keep")  cfg.collect = CollectModel::Keep;
+            else if (v.is_string() && v.string == "piles") cfg.collect = CollectModel::Piles;
+            else return fail("sorted, keep or piles");
+        }
+        else if (key == "shuffles") {
+            if (!v.is_array() || v.array.empty()) return fail("a list of cut, riffle, hindu or overhand");
+            cfg.shuffles.clear();
+            for (const JsonValue& s : v.array) {
+                Shuffle shuffle;
+                if (s.is_string() && s.string == "cut")           shuffle = Shuffle::Cut;
+                else if (s.is_string() && s.string == "riffle")   shuffle = Shuffle::Riffle;
+                else if (s.is_string() && s.string == "hindu")    shuffle = Shuffle::Hindu;
+                else if (s.is_string() && s.string == "overhand") shuffle = Shuffle::Overhand;
+                else return fail("a list of cut, riffle, hindu or overhand");
+
+                for (Shuffle seen : cfg.shuffles) {
+                    if (seen == shuffle) return fail("a list without repeats");
+                }
+                cfg.shuffles.push_back(shuffle);
+            }
+        }
+        else if (key == "share_prefixes") {
+            if (v.type != JsonValue::Type::Bool) return fail("true or false");
+            cfg.sharePrefixes = v.boolean;
+        }
+        else if (key == "weights") {
+            if (!v.is_object()) return fail("an object of uniformity, adjacency, mixing and poker weights");
+            for (const auto& [test, w] : v.object) {
+                double* weight;
+                if (test == "uniformity")     weight = &cfg.weights.uniformity;
+                else if (test == "adjacency") weight = &cfg.weights.adjacency;
+                else if (test == "mixing")    weight = &cfg.weights.displacement;
+                else if (test == "poker")     weight = &cfg.weights.poker;
+                else return fail("an object of uniformity, adjacency, mixing and poker weights");
+
+                if (!w.is_number() || !(w.number >= 0) || w.number > 1000) return fail("weights between 0 and 1000");
+                *weight = w.number;
+            }
+        }
+        else {
+            err = "unknown key \"" + key + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_experiment(const ExperimentRunner::ExperimentConfig& cfg, std::string& err) {
+    if (!cfg.testUniformity && !cfg.testAdjacency && !cfg.testMixing && !cfg.testPoker) {
+        err = "no tests enabled";
+        return false;
+    }
+    if (cfg.sharePrefixes && cfg.streamHands > 0) {
+        err = "share_prefixes does not apply to stream experiments";
+        return false;
+    }
+    if (!ExperimentRunner::weights_valid(cfg)) {
+        err = "weights must give an enabled test a weight above 0";
+        return false;
+    }
+    return true;
+}
+
+bool load_manifest(const std::string& path, Manifest& manifest, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "could not read manifest " + path;
+        return false;
+    }
+    std::stringstream buf;
+    buf << in.rdbuf();
+
+    auto fail = [&](const std::string& msg) {
+        err = path + ": " + msg;
+        return false;
+    };
+
+    JsonValue root;
+    std::string parseErr;
+    if (!parse_json(buf.str(), root, parseErr)) return fail(parseErr);
+    if (!root.is_object()) return fail("expected an object with an experiments list");
+
+    // same defaults as a plain --run
+    ExperimentRunner::ExperimentConfig base;
+    base.kMax = 5;
+    base.trials = 50;
+    base.testUniformity = base.testAdjacency = base.testMixing = true;
+    bool baseSeed = false, sawSeed = false;
+
+    const JsonValue* experiments = nullptr;
+    for (const auto& [key, v] : root.object) {
+        if (key == "experiments") {
+            if (!v.is_array() || v.array.empty()) return fail("\"experiments\" must be a non-empty list");
+            experiments = &v;
+        }
+        else if (key == "threads") {
+            if (!get_int(v, 0, 4096, manifest.threads)) return fail("\"threads\" must be between 0 (all cores) and 4096");
+        }
+        else if (key == "cache") {
+            if (!v.is_string() || v.string.empty()) return fail("\"cache\" must be a file path");
+            manifest.cachePath = v.string;
+        }
+        else if (key == "seed") {
+            if (!get_seed(v, manifest.seed)) return fail("\"seed\" must be a whole number (a string of digits above 2^53)");
+            sawSeed = true;
+        }
+        else if (key == "defaults") {
+            std::string unused;
+            if (!apply_experiment_keys(v, base, unused, baseSeed, err)) return fail("defaults: " + err);
+        }
+        else {
+            return fail("unknown key \"" + key + "\"");
+        }
+    }
+    if (!experiments) return fail("missing \"experiments\" list");
+    if (baseSeed) {
+        manifest.seed = base.seed;
+    } else if (!sawSeed) {
+        std::random_device rd;
+        manifest.seed = (static_cast<uint64_t>(rd()) << 32) | rd(); // printed so the batch can be repeated
+    }
+
+    manifest.experiments.clear();
+    for (std::size_t i = 0; i < experiments->array.size(); ++i) {
+        Manifest::Experiment e;
+        e.name = "#";
+        e.name += std::to_string(i + 1);
+        e.cfg = base;
+        e.cfg.seed = manifest.seed;
+
+        bool ownSeed = false;
+        if (!apply_experiment_keys(experiments->array[i], e.cfg, e.name, ownSeed, err) || !check_experiment(e.cfg, err)) {
+            return fail("experiment " + e.name + ": " + err);
+        }
+        manifest.experiments.push_back(std::move(e));
+    }
+    return true;
+}
+
+ManifestOutcome run_manifest(const Manifest& manifest) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    ThreadPool pool(manifest.threads);
+    ResultCache cache(manifest.cachePath); // no file: shared in memory for this process only
+
+    ManifestOutcome out;
+    for (const Manifest::Experiment& e : manifest.experiments) {
+        const auto experimentStart = Clock::now();
+
+        ExperimentRunner::ExperimentConfig cfg = e.cfg;
+        cfg.threads = manifest.threads;
+        ExperimentRunner runner(cfg);
+        runner.share(&pool, &cache);
+        const ExperimentRunner::SweepOutcome sweep = runner.sweep();
+
+        ManifestOutcome::Experiment result;
+        result.name = e.name;
+        result.sequences = sweep.sequences;
+        result.reused = sweep.cacheHits;
+        result.best = runner.shuffles_of(sweep.bestSeqIdx);
+        result.bestScore = sweep.bestScore;
+        result.seconds = std::chrono::duration<double>(Clock::now() - experimentStart).count();
+        out.experiments.push_back(std::move(result));
+    }
+
+    if (!manifest.cachePath.empty() && !cache.flush()) {
+        std::cerr << "warning: failed to write cache " << manifest.cachePath << "\n";
+    }
+    out.cacheEntries = cache.size();
+    out.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return out;
+}
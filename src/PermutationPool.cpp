@@ -0,0 +1,207 @@
+#include "PermutationPool.h"
+#include "BinaryIO.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring> // memcmp
+#include <iostream>
+#include <memory>
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+static constexpr char POOL_MAGIC[8] = {'S', 'L', 'P', 'O', 'O', 'L', '0', '1'};
+
+// magic, model fingerprint, contents fingerprint, entries per shuffle
+static constexpr std::size_t HEADER_SIZE = sizeof(POOL_MAGIC) + 3 * sizeof(uint64_t);
+
+static constexpr std::size_t CHUNKS = 256; // per shuffle, fixed so the pool does not depend on threads
+static constexpr uint64_t POOL_SEED_MIX = 0x8CB92BA72F3D8DD7ull; // pool streams != sweep streams
+
+static constexpr std::array<Shuffle, PermutationPool::SHUFFLES> POOLED = {Shuffle::Cut, Shuffle::Riffle, Shuffle::Hindu, Shuffle::Overhand};
+
+// FNV-1a over the model and the entries, a word at a time (an entry is 26 words)
+static uint64_t pool_hash(const uint8_t* data, std::size_t bytes) {
+    uint64_t h = 14695981039346656037ULL;
+    h = (h ^ model_fingerprint()) * 1099511628211ULL;
+    for (std::size_t i = 0; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Every entry a permutation of the deck's positions - a corrupt file must not index past a deck
+static bool valid_entries(const uint8_t* data, std::size_t count) {
+    for (std::size_t e = 0; e < count; ++e) {
+        uint64_t seen = 0;
+        for (const uint8_t* p = data + e * DECK_SIZE; p != data + (e + 1) * DECK_SIZE; ++p) {
+            if (*p >= DECK_SIZE) return false;
+            seen |= uint64_t(1) << *p;
+        }
+        if (seen != (uint64_t(1) << DECK_SIZE) - 1) return false;
+    }
+    return true;
+}
+
+PermutationPool::~PermutationPool() {
+    unmap();
+}
+
+void PermutationPool::unmap() {
+    if (mapBase) munmap(mapBase, mapLength);
+    mapBase = nullptr;
+    mapLength = 0;
+}
+
+void PermutationPool::build(uint32_t size, uint64_t seed, ThreadPool& pool) {
+    unmap();
+    entries = size;
+    owned.assign(static_cast<std::size_t>(SHUFFLES) * size * DECK_SIZE, 0);
+    data = owned.data();
+
+    pool.parallel_for(SHUFFLES * CHUNKS, [&](std::size_t task) {
+        const Shuffle s = POOLED[task / CHUNKS];
+        const std::size_t c = task % CHUNKS;
+
+        DeckContext ctx;
+        ctx.rng.seed(seed ^ POOL_SEED_MIX, (static_cast<uint64_t>(s) << 8) | c);
+
+        for (std::size_t i = size * c / CHUNKS; i < size * (c + 1) / CHUNKS; ++i) {
+            ctx.reset();
+            switch (s) {
+                case Shuffle::Cut:      ctx.cut(); break;
+                case Shuffle::Riffle:   ctx.riffle(); break;
+                case Shuffle::Hindu:    ctx.hindu(); break;
+                case Shuffle::Overhand: ctx.overhand(); break;
+                case Shuffle::RandomTest: break;
+            }
+            // sorted deck in, so the deck is the permutation itself
+            std::memcpy(owned.data() + (static_cast<std::size_t>(static_cast<int>(s) - 1) * size + i) * DECK_SIZE, ctx.deck.data(), DECK_SIZE);
+        }
+    });
+
+    hash = pool_hash(data, owned.size());
+}
+
+bool PermutationPool::load(const std::string& path, uint32_t size) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    const std::size_t expected = HEADER_SIZE + static_cast<std::size_t>(SHUFFLES) * size * DECK_SIZE;
+    bool ok = false;
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == expected) {
+        void* base = mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+            const char* bytes = static_cast<const char*>(base);
+            uint64_t modelHash = 0, contentHash = 0, count = 0;
+            std::memcpy(&modelHash, bytes + sizeof(POOL_MAGIC), sizeof(modelHash));
+            std::memcpy(&contentHash, bytes + sizeof(POOL_MAGIC) + 8, sizeof(contentHash));
+            std::memcpy(&count, bytes + sizeof(POOL_MAGIC) + 16, sizeof(count));
+
+            // a pool sampled under other model parameters is a different experiment, and one
+            // whose entries are not permutations (or not the ones hashed) is corrupt
+            const uint8_t* body = reinterpret_cast<const uint8_t*>(bytes + HEADER_SIZE);
+            if (std::memcmp(bytes, POOL_MAGIC, sizeof(POOL_MAGIC)) == 0 && modelHash == model_fingerprint() && count == size &&
+                valid_entries(body, static_cast<std::size_t>(SHUFFLES) * size) &&
+                pool_hash(body, expected - HEADER_SIZE) == contentHash) {
+                unmap();
+                owned.clear();
+                mapBase = base;
+                mapLength = expected;
+                data = body;
+                entries = size;
+                hash = contentHash;
+                ok = true;
+            } else {
+                munmap(base, expected);
+            }
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+bool PermutationPool::save(const std::string& path) const {
+    return write_file_atomic(path, [&](BinaryWriter& w) {
+        w.put(POOL_MAGIC);
+        w.put<uint64_t>(model_fingerprint());
+        w.put<uint64_t>(hash);
+        w.put<uint64_t>(entries);
+        const std::size_t bytes = static_cast<std::size_t>(SHUFFLES) * entries * DECK_SIZE;
+        w.ok = w.ok && std::fwrite(data, 1, bytes, w.f) == bytes;
+    });
+}
+
+// ===== Pooled Runs =====
+
+void ExperimentRunner::prepare_pool(bool& mapped, double& seconds) {
+    const auto start = std::chrono::steady_clock::now();
+
+    auto pool = std::make_shared<PermutationPool>();
+    const uint32_t size = static_cast<uint32_t>(cfg.poolSize);
+    mapped = !cfg.poolPath.empty() && pool->load(cfg.poolPath, size);
+    if (!mapped) {
+        pool->build(size, cfg.seed, workers());
+
+        if (!cfg.poolPath.empty() && !pool->save(cfg.poolPath)) {
+            std::cerr << "warning: failed to write permutation pool " << cfg.poolPath << "\n";
+        }
+    }
+    permutations = std::move(pool);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The check_sequences (POOL_CHECK_SEQUENCES), each scored three times: pooled, direct,
+// and direct under another seed.
+// Two direct runs differ by Monte Carlo noise alone, so whatever pooled-vs-direct
+// difference exceeds it is the pool's. Differences are taken in log(1 + score): a poorly
+// mixed sequence scores in the thousands with noise to match, and would swamp the rest.
+ExperimentRunner::PoolCheck ExperimentRunner::check_pool(const std::vector<int>& bestSeqIdx) {
+    const std::vector<std::vector<int>> seqs = check_sequences(bestSeqIdx, POOL_CHECK_SEQUENCES);
+    ThreadPool& pool = workers();
+
+    auto scores = [&]() {
+        std::vector<double> out(seqs.size());
+        pool.parallel_for(seqs.size(), [&](std::size_t i) {
+            DeckContext ctx;
+            out[i] = evaluate_sequence(ctx, seqs[i]).score;
+        });
+        return out;
+    };
+
+    const std::vector<double> pooled = scores();
+    const auto pooledWith = std::move(permutations);
+    const std::vector<double> direct = scores();
+    const uint64_t seed = cfg.seed;
+    cfg.seed = seed ^ POOL_SEED_MIX;
+    const std::vector<double> other = scores();
+    cfg.seed = seed;
+    permutations = pooledWith;
+
+    PoolCheck check;
+    check.sequences = static_cast<int>(seqs.size());
+    check.length = static_cast<int>(bestSeqIdx.size());
+    double pooledSq = 0, noiseSq = 0;
+    for (std::size_t i = 0; i < seqs.size(); ++i) {
+        const double d = std::log1p(pooled[i]) - std::log1p(direct[i]);
+        const double noise = std::log1p(other[i]) - std::log1p(direct[i]);
+        pooledSq += d * d;
+        noiseSq += noise * noise;
+        check.bias += d;
+    }
+    const double n = static_cast<double>(seqs.size());
+    check.pooledRms = std::sqrt(pooledSq / n);
+    check.noiseRms = std::sqrt(noiseSq / n);
+    check.poolError = std::sqrt(std::max(0.0, (pooledSq - noiseSq) / n));
+    check.bias /= n;
+    check.bestPooled = pooled[0];
+    check.bestDirect = direct[0];
+    return check;
+}
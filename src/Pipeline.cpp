@@ -0,0 +1,136 @@
+#include "Pipeline.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr std::size_t DRAIN_BATCH = 64;
+
+// Brief spin before giving up the core - stages may outnumber the cores
+void backoff(int& spins) {
+    if (++spins < 64) return;
+    std::this_thread::yield();
+}
+
+} // namespace
+
+void DeckSink::push(const Deck& deck) {
+    PipelineSlot slot;
+    slot.job = job;
+    slot.deck = deck;
+    for (int spins = 0; !ring->try_push(slot);) backoff(spins);
+}
+
+DeckPipeline::DeckPipeline(int shuffleWorkers, int statsWorkers, std::size_t ringCapacity)
+    : numShuffle(std::max(1, shuffleWorkers)), numStats(std::max(1, statsWorkers))
+{
+    rings.reserve(static_cast<std::size_t>(numShuffle) * numStats);
+    for (int i = 0; i < numShuffle * numStats; ++i) {
+        rings.push_back(std::make_unique<SpscRing<PipelineSlot>>(ringCapacity));
+    }
+
+    workers.reserve(numShuffle + numStats);
+    for (int w = 0; w < numShuffle + numStats; ++w) {
+        workers.emplace_back([this, w] { worker_loop(w); });
+    }
+}
+
+DeckPipeline::~DeckPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+void DeckPipeline::run(std::size_t jobs, const Stages& s) {
+    if (jobs == 0) return;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    stages = &s;
+    jobCount = jobs;
+    nextJob.store(0);
+    shufflersDone.store(0);
+    active = numShuffle + numStats;
+    ++generation;
+    cv.notify_all();
+
+    cv.wait(lock, [this] { return active == 0; });
+    stages = nullptr;
+}
+
+void DeckPipeline::worker_loop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        if (worker < numShuffle) shuffle_worker(worker);
+        else                     stats_worker(worker - numShuffle);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--active == 0) cv.notify_all();
+    }
+}
+
+void DeckPipeline::shuffle_worker(int s) {
+    DeckContext ctx;
+    DeckSink sink;
+
+    for (std::size_t j; (j = nextJob.fetch_add(1)) < jobCount;) {
+        sink.ring = rings[static_cast<std::size_t>(s) * numStats + j % numStats].get();
+        sink.job = static_cast<uint32_t>(j);
+
+        ctx.numShuffles = 0;
+        stages->produce(j, ctx, sink);
+
+        PipelineSlot end;
+        end.job = sink.job;
+        end.numShuffles = static_cast<uint32_t>(ctx.numShuffles);
+        end.last = true;
+        for (int spins = 0; !sink.ring->try_push(end);) backoff(spins);
+    }
+
+    shufflersDone.fetch_add(1, std::memory_order_release);
+}
+
+void DeckPipeline::stats_worker(int c) {
+    // One in-progress job per incoming ring (each shuffle worker finishes a job before starting the next)
+    std::vector<DeckContext> acc(numShuffle);
+
+    auto drain_all = [&] {
+        std::size_t got = 0;
+        for (int s = 0; s < numShuffle; ++s) {
+            DeckContext& a = acc[s];
+            got += rings[static_cast<std::size_t>(s) * numStats + c]->drain([&](const PipelineSlot& slot) {
+                if (!slot.last) {
+                    a.deck = slot.deck;
+                    stages->observe(a);
+                    return;
+                }
+                a.numShuffles = static_cast<int>(slot.numShuffles);
+                stages->finish(slot.job, a);
+                a = DeckContext{};
+            }, DRAIN_BATCH);
+        }
+        return got;
+    };
+
+    for (int spins = 0;;) {
+        if (drain_all() > 0) {
+            spins = 0;
+            continue;
+        }
+        // Producers are done: whatever they pushed is visible now, take it and stop
+        if (shufflersDone.load(std::memory_order_acquire) == numShuffle) {
+            while (drain_all() > 0) {}
+            return;
+        }
+        backoff(spins);
+    }
+}
@@ -0,0 +1,251 @@
+#include "Profile.h"
+
+#include <array>
+#include <cstring> // memset
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace profile {
+
+namespace {
+
+struct StageStats {
+    uint64_t calls = 0;
+    uint64_t ns = 0;
+    std::array<uint64_t, COUNTER_COUNT> counters{};
+};
+
+// One per thread that entered a scope; owned by the registry so stats outlive the thread
+struct ThreadProfile {
+    std::array<StageStats, STAGE_COUNT> stages{};
+    int groupFd = -1;
+    std::array<int, COUNTER_COUNT> slot{}; // position of each counter in a group read, -1 = not opened
+    int opened = 0;
+    std::vector<int> fds;
+};
+
+std::mutex registryMtx;
+std::vector<std::unique_ptr<ThreadProfile>> registry;
+bool countersProbed = false;
+bool countersOk = false;
+
+constexpr const char* STAGE_NAMES[STAGE_COUNT] = {
+    "Cut", "Riffle", "Hindu", "Overhand", "RandomTest",
+    "Uniformity", "Adjacency", "Displacement", "Poker",
+    "Uniformity", "Adjacency", "Displacement", "Poker"
+};
+
+long perf_event_open(perf_event_attr* attr, int groupFd) {
+    return syscall(SYS_perf_event_open, attr, 0, -1, groupFd, 0); // this thread, any cpu
+}
+
+perf_event_attr counter_attr(Counter c) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1; // user-space work only (also hides our own read() calls)
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    switch (c) {
+        case Cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case BranchMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case L1DMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            break;
+    }
+    return attr;
+}
+
+// Open this thread's counter group (cycles leads; members that fail are skipped)
+void open_counters(ThreadProfile& tp) {
+    tp.slot.fill(-1);
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        perf_event_attr attr = counter_attr(static_cast<Counter>(c));
+        attr.disabled = (tp.groupFd < 0) ? 1 : 0;
+
+        int fd = static_cast<int>(perf_event_open(&attr, tp.groupFd));
+        if (fd < 0) {
+            if (tp.groupFd < 0) return; // no leader, no counters on this thread
+            continue;
+        }
+        if (tp.groupFd < 0) tp.groupFd = fd;
+        tp.fds.push_back(fd);
+        tp.slot[c] = tp.opened++;
+    }
+    ioctl(tp.groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(tp.groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void close_counters(ThreadProfile& tp) {
+    for (int fd : tp.fds) close(fd);
+    tp.fds.clear();
+    tp.groupFd = -1;
+}
+
+// Closes the thread's perf fds on thread exit; stats stay in the registry
+struct ThreadHandle {
+    ThreadProfile* tp = nullptr;
+    ~ThreadHandle() {
+        if (tp) close_counters(*tp);
+    }
+};
+
+ThreadProfile& this_thread_profile() {
+    thread_local ThreadHandle handle;
+    if (!handle.tp) {
+        auto tp = std::make_unique<ThreadProfile>();
+        if (countersOk) open_counters(*tp);
+        handle.tp = tp.get();
+        std::lock_guard<std::mutex> lock(registryMtx);
+        registry.push_back(std::move(tp));
+    }
+    return *handle.tp;
+}
+
+void read_counters(const ThreadProfile& tp, uint64_t out[COUNTER_COUNT]) {
+    if (tp.groupFd < 0) return;
+
+    uint64_t buf[1 + COUNTER_COUNT] = {}; // nr, values...
+    if (read(tp.groupFd, buf, sizeof(uint64_t) * (1 + tp.opened)) <= 0) return;
+
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        if (tp.slot[c] >= 0) out[c] = buf[1 + tp.slot[c]];
+    }
+}
+
+} // namespace
+
+void enable() {
+    enabled = true;
+
+    if (!countersProbed) {
+        countersProbed = true;
+        perf_event_attr attr = counter_attr(Cycles);
+        int fd = static_cast<int>(perf_event_open(&attr, -1));
+        countersOk = fd >= 0;
+        if (fd >= 0) close(fd);
+    }
+}
+
+bool counters_available() {
+    return countersOk;
+}
+
+void begin_scope(uint64_t counters[COUNTER_COUNT]) {
+    read_counters(this_thread_profile(), counters);
+}
+
+void end_scope(Stage stage, std::chrono::steady_clock::time_point start, const uint64_t counters[COUNTER_COUNT]) {
+    const auto stop = std::chrono::steady_clock::now();
+
+    ThreadProfile& tp = this_thread_profile();
+    uint64_t now[COUNTER_COUNT] = {};
+    read_counters(tp, now);
+
+    StageStats& s = tp.stages[stage];
+    ++s.calls;
+    s.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        s.counters[c] += now[c] - counters[c];
+    }
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registryMtx);
+    for (auto& tp : registry) tp->stages = {};
+}
+
+void print_report(double wallSeconds) {
+    std::array<StageStats, STAGE_COUNT> total{};
+    {
+        std::lock_guard<std::mutex> lock(registryMtx);
+        for (const auto& tp : registry) {
+            for (int st = 0; st < STAGE_COUNT; ++st) {
+                total[st].calls += tp->stages[st].calls;
+                total[st].ns += tp->stages[st].ns;
+                for (int c = 0; c < COUNTER_COUNT; ++c) total[st].counters[c] += tp->stages[st].counters[c];
+            }
+        }
+    }
+
+    uint64_t profiledNs = 0;
+    for (const StageStats& s : total) profiledNs += s.ns;
+
+    std::cout << "\n\n[Profile — Hot Path]\n";
+    std::cout << "  Wall time : " << std::fixed << std::setprecision(3) << wallSeconds << " s"
+              << "  (stage times are summed over threads)\n";
+    if (!countersOk) {
+        std::cout << "  Hardware counters unavailable (perf_event_open denied or unsupported)\n";
+    }
+
+    std::cout << "\n  " << std::left << std::setw(22) << "stage" << std::right
+              << std::setw(12) << "calls" << std::setw(11) << "ms" << std::setw(8) << "%"
+              << std::setw(10) << "ns/call";
+    if (countersOk) {
+        std::cout << std::setw(12) << "cyc/call" << std::setw(7) << "IPC"
+                  << std::setw(11) << "brmiss/call" << std::setw(11) << "L1miss/call";
+    }
+    std::cout << "\n";
+
+    auto row = [&](const std::string& name, const StageStats& s) {
+        if (s.calls == 0) return;
+        const double calls = static_cast<double>(s.calls);
+        std::cout << "  " << std::left << std::setw(22) << name << std::right
+                  << std::setw(12) << s.calls
+                  << std::setw(11) << std::setprecision(1) << s.ns / 1e6
+                  << std::setw(7) << (profiledNs ? 100.0 * s.ns / profiledNs : 0) << "%"
+                  << std::setw(10) << std::setprecision(1) << s.ns / calls;
+        if (countersOk) {
+            const double cyc = s.counters[Cycles];
+            std::cout << std::setw(12) << std::setprecision(0) << cyc / calls
+                      << std::setw(7) << std::setprecision(2) << (cyc > 0 ? s.counters[Instructions] / cyc : 0)
+                      << std::setw(11) << std::setprecision(2) << s.counters[BranchMisses] / calls
+                      << std::setw(11) << std::setprecision(2) << s.counters[L1DMisses] / calls;
+        }
+        std::cout << "\n";
+    };
+
+    // Per-stage totals, then the per-model / per-test breakdown
+    struct Group { const char* name; int first, last; };
+    for (const Group& g : {Group{"Shuffle", ShuffleCut, ShuffleRandomTest},
+                           Group{"Observe", ObserveUniformity, ObservePoker},
+                           Group{"Report", ReportUniformity, ReportPoker}}) {
+        StageStats sum;
+        for (int st = g.first; st <= g.last; ++st) {
+            sum.calls += total[st].calls;
+            sum.ns += total[st].ns;
+            for (int c = 0; c < COUNTER_COUNT; ++c) sum.counters[c] += total[st].counters[c];
+        }
+        row(g.name, sum);
+        for (int st = g.first; st <= g.last; ++st) {
+            row(std::string("  ") + STAGE_NAMES[st], total[st]);
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+} // namespace profile
@@ -0,0 +1,111 @@
+#include "Ranking.h"
+
+#include <algorithm>
+
+namespace {
+
+using Deviations = std::array<double, ExperimentRunner::OBJECTIVES>;
+
+// a at least as close as b on every test and closer on one
+bool dominates(const Deviations& a, const Deviations& b) {
+    bool closer = false;
+    for (int o = 0; o < ExperimentRunner::OBJECTIVES; ++o) {
+        if (a[o] > b[o]) return false;
+        closer |= a[o] < b[o];
+    }
+    return closer;
+}
+
+// Heap order: larger key (then larger rank) nearer the root
+bool worse(double keyA, uint64_t rankA, double keyB, uint64_t rankB) {
+    return keyA != keyB ? keyA < keyB : rankA < rankB;
+}
+
+} // namespace
+
+void RankingTracker::push_bounded(std::vector<Entry>& heap, double key, const SequenceResult& r) {
+    if (k == 0) return;
+
+    auto cmp = [](const Entry& a, const Entry& b) { return worse(a.key, a.result.rank, b.key, b.result.rank); };
+    if (heap.size() < k) {
+        heap.push_back({key, r});
+        std::push_heap(heap.begin(), heap.end(), cmp);
+        return;
+    }
+
+    const Entry& root = heap.front();
+    if (!worse(key, r.rank, root.key, root.result.rank)) return; // no better than the worst kept
+
+    std::pop_heap(heap.begin(), heap.end(), cmp);
+    heap.back() = {key, r};
+    std::push_heap(heap.begin(), heap.end(), cmp);
+}
+
+void RankingTracker::offer(const SequenceResult& r) {
+    const Deviations dev = ExperimentRunner::deviations(r);
+
+    const double values[ExperimentRunner::OBJECTIVES] = {r.uniformity, r.adjacency, r.displacement, r.poker};
+    for (int o = 0; o < ExperimentRunner::OBJECTIVES; ++o) {
+        if (values[o] != -1) push_bounded(objectiveHeaps[o], dev[o], r); // disabled tests keep no list
+    }
+    push_bounded(scoreHeap, r.score, r);
+
+    offer_front(r, dev);
+}
+
+void RankingTracker::offer_front(const SequenceResult& r, const Deviations& dev) {
+    for (const Deviations& member : frontDeviations) {
+        if (dominates(member, dev)) return;
+    }
+
+    // Drop members the newcomer dominates, keeping the rest in rank order
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < front.size(); ++i) {
+        if (dominates(dev, frontDeviations[i])) continue;
+        front[kept] = front[i];
+        frontDeviations[kept] = frontDeviations[i];
+        ++kept;
+    }
+    front.resize(kept);
+    frontDeviations.resize(kept);
+
+    const auto pos = std::upper_bound(front.begin(), front.end(), r.rank,
+                                      [](uint64_t rank, const SequenceResult& m) { return rank < m.rank; });
+    frontDeviations.insert(frontDeviations.begin() + (pos - front.begin()), dev);
+    front.insert(pos, r);
+}
+
+// A checkpoint holds the lists, not the heaps - pushing them again rebuilds the same state,
+// as they hold everything the heaps kept and no front member dominates another
+void RankingTracker::restore(const ExperimentRunner::Rankings& saved) {
+    for (const SequenceResult& r : saved.front) offer_front(r, ExperimentRunner::deviations(r));
+
+    const double SequenceResult::*fields[ExperimentRunner::OBJECTIVES] = {
+        &SequenceResult::uniformity, &SequenceResult::adjacency, &SequenceResult::displacement, &SequenceResult::poker};
+    for (int o = 0; o < ExperimentRunner::OBJECTIVES; ++o) {
+        for (const SequenceResult& r : saved.byObjective[o]) {
+            if (r.*fields[o] != -1) push_bounded(objectiveHeaps[o], ExperimentRunner::deviations(r)[o], r);
+        }
+    }
+    for (const SequenceResult& r : saved.byScore) push_bounded(scoreHeap, r.score, r);
+}
+
+std::vector<ExperimentRunner::SequenceResult> RankingTracker::sorted(const std::vector<Entry>& heap) const {
+    std::vector<Entry> entries = heap;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return worse(a.key, a.result.rank, b.key, b.result.rank);
+    });
+
+    std::vector<SequenceResult> out;
+    out.reserve(entries.size());
+    for (const Entry& e : entries) out.push_back(e.result);
+    return out;
+}
+
+ExperimentRunner::Rankings RankingTracker::rankings() const {
+    ExperimentRunner::Rankings out;
+    for (int o = 0; o < ExperimentRunner::OBJECTIVES; ++o) out.byObjective[o] = sorted(objectiveHeaps[o]);
+    out.byScore = sorted(scoreHeap);
+    out.front = front;
+    return out;
+}
@@ -1,11 +1,20 @@
 #include "Report.h"
+#include "HandEvaluator.h"
+
+#include <cmath> // std::abs
+#include <iomanip>
 
 UniformityReport report_uniformity(const DeckContext& ctx) {
     UniformityReport report;
 
     if (ctx.numShuffles == 0) return report;
 
-    double E = static_cast<double>(ctx.numShuffles) / DECK_SIZE; // Expected freq
+    // One observation per trial (not per shuffle), so sequences of any length compare
+    int observations = 0;
+    for (int pos = 0; pos < DECK_SIZE; ++pos) observations += ctx.posFreq[0][pos];
+    if (observations == 0) return report;
+
+    double E = static_cast<double>(observations) / DECK_SIZE; // Expected freq
 
     double sum = 0;
 
@@ -113,3 +122,78 @@ void print_report(const DisplacementReport& r) {
     std::cout << "  Mean : " << r.mean << "\n";
     std::cout << "  Expected ≈ 17.33\n\n";
 }
+
+// Rare classes share a chi-squared bin so expected counts stay usable at small trial counts
+static constexpr int POKER_BINS = 7; // high card .. flush, full house or better
+static constexpr int poker_bin(int cls) { return cls < FullHouse ? cls : FullHouse; }
+
+PokerReport report_poker(const DeckContext& ctx, int seats) {
+    PokerReport report;
+    report.seats = seats;
+    report.deals = ctx.pokerDeals;
+
+    if (ctx.pokerDeals == 0) return report;
+
+    const double deals = ctx.pokerDeals;
+
+    std::array<double, POKER_BINS> binProb{};
+    for (int cls = 0; cls < HAND_CLASSES; ++cls) binProb[poker_bin(cls)] += HAND_CLASS_PROB[cls];
+
+    // Each seat's 7 cards are a uniform 7-card hand under a uniform deal
+    for (int seat = 0; seat < seats; ++seat) {
+        std::array<double, POKER_BINS> observed{};
+        for (int cls = 0; cls < HAND_CLASSES; ++cls) {
+            const int count = ctx.pokerClassFreq[seat][cls];
+            report.classFreq[seat][cls] = count / deals;
+            report.maxClassDev = std::max(report.maxClassDev, std::abs(count / deals - HAND_CLASS_PROB[cls]));
+            observed[poker_bin(cls)] += count;
+        }
+        for (int bin = 0; bin < POKER_BINS; ++bin) {
+            double E = deals * binProb[bin];
+            double dev = observed[bin] - E;
+            report.chiSq += (dev * dev) / E;
+        }
+        report.df += POKER_BINS - 1;
+    }
+
+    // ...and every seat is equally likely to win the pot
+    const double E = deals / seats;
+    for (int seat = 0; seat < seats; ++seat) {
+        report.equity[seat] = ctx.pokerEquity[seat] / deals;
+        report.maxEquityDev = std::max(report.maxEquityDev, std::abs(report.equity[seat] - 1.0 / seats));
+        double dev = ctx.pokerEquity[seat] - E;
+        report.chiSq += (dev * dev) / E;
+    }
+    report.df += seats - 1;
+
+    // seats share a board, so terms are correlated - each still has the stated expectation
+    report.reducedChiSq = report.chiSq / report.df;
+
+    return report;
+}
+
+void print_report(const PokerReport& r) {
+    std::cout << "[Hold'em Deal — " << r.seats << " Seats]\n";
+    std::cout << "  Seat equity : ";
+    for (int seat = 0; seat < r.seats; ++seat) {
+        std::cout << std::fixed << std::setprecision(3) << r.equity[seat] << (seat + 1 < r.seats ? " " : "");
+    }
+    std::cout << "  (uniform " << 1.0 / r.seats << ")\n";
+    std::cout << "  Max equity deviation     : " << r.maxEquityDev << "\n";
+    std::cout << "  Max hand-class deviation : " << r.maxClassDev << "\n";
+    std::cout << "  " << std::left << std::setw(16) << "Hand class" << std::right
+              << std::setw(9) << "uniform" << std::setw(9) << "min" << std::setw(9) << "max" << "  (share over seats)\n";
+    for (int cls = 0; cls < HAND_CLASSES; ++cls) {
+        double lo = 1, hi = 0;
+        for (int seat = 0; seat < r.seats; ++seat) {
+            lo = std::min(lo, r.classFreq[seat][cls]);
+            hi = std::max(hi, r.classFreq[seat][cls]);
+        }
+        std::cout << "  " << std::left << std::setw(16) << to_string(static_cast<HandClass>(cls)) << std::right
+                  << std::setprecision(4) << std::setw(9) << HAND_CLASS_PROB[cls]
+                  << std::setw(9) << lo << std::setw(9) << hi << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "  χ² / df : " << r.reducedChiSq << " (" << r.chiSq << " / " << r.df << ")\n";
+    std::cout << "  Expected χ² / df ≈ 1\n\n";
+}
@@ -0,0 +1,166 @@
+#include "ResultCache.h"
+#include "BinaryIO.h"
+
+#include <algorithm>
+#include <cstring> // memcmp
+#include <iterator>
+#include <tuple>
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+static constexpr char CACHE_MAGIC[8] = {'S', 'L', 'C', 'A', 'C', 'H', '0', '3'};
+static constexpr std::size_t HEADER_SIZE = sizeof(CACHE_MAGIC) + sizeof(uint64_t);
+
+static_assert(sizeof(ResultCache::Record) == 72, "cache record layout is part of the file format");
+
+// splitmix64 finaliser
+static uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t key_hash(const ResultCache::Key& k) {
+    uint64_t h = mix64(k.modelHash);
+    h = mix64(h ^ k.seqCode);
+    h = mix64(h ^ k.seed);
+    h = mix64(h ^ ((static_cast<uint64_t>(k.trials) << 32) | k.tests));
+    return h;
+}
+
+static auto order_tuple(const ResultCache::Record& r) {
+    return std::tie(r.hash, r.key.modelHash, r.key.seqCode, r.key.seed, r.key.trials, r.key.tests);
+}
+
+static bool record_less(const ResultCache::Record& a, const ResultCache::Record& b) {
+    return order_tuple(a) < order_tuple(b);
+}
+
+static bool record_same_key(const ResultCache::Record& a, const ResultCache::Record& b) {
+    return order_tuple(a) == order_tuple(b);
+}
+
+// Binary search a sorted record range
+static const ResultCache::Record* find_record(const ResultCache::Record* first, std::size_t count, const ResultCache::Record& probe) {
+    const ResultCache::Record* last = first + count;
+    const ResultCache::Record* it = std::lower_bound(first, last, probe, record_less);
+    return (it != last && record_same_key(*it, probe)) ? it : nullptr;
+}
+
+ResultCache::ResultCache(const std::string& path) : path(path) {
+    map_file();
+}
+
+ResultCache::~ResultCache() {
+    unmap_file();
+}
+
+void ResultCache::map_file() {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return; // no cache yet
+
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= HEADER_SIZE) {
+        void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+            const char* bytes = static_cast<const char*>(base);
+            uint64_t count = 0;
+            std::memcpy(&count, bytes + sizeof(CACHE_MAGIC), sizeof(count));
+
+            // ignore files that aren't ours, truncated or padded - compared by division, as a
+            // corrupt count times the record size could wrap around
+            const std::size_t body = static_cast<std::size_t>(st.st_size) - HEADER_SIZE;
+            if (std::memcmp(bytes, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                body % sizeof(Record) == 0 && count == body / sizeof(Record)) {
+                mapBase = base;
+                mapLength = st.st_size;
+                mapped = reinterpret_cast<const Record*>(bytes + HEADER_SIZE);
+                mappedCount = count;
+            } else {
+                munmap(base, st.st_size);
+            }
+        }
+    }
+    ::close(fd);
+}
+
+void ResultCache::unmap_file() {
+    if (mapBase) munmap(mapBase, mapLength);
+    mapBase = nullptr;
+    mapLength = 0;
+    mapped = nullptr;
+    mappedCount = 0;
+}
+
+bool ResultCache::lookup(const Key& key, Value& value) const {
+    Record probe{key_hash(key), key, {}};
+    std::shared_lock lock(mtx);
+
+    if (const Record* r = find_record(mapped, mappedCount, probe)) {
+        value = r->value;
+        return true;
+    }
+
+    auto [first, last] = pendingIndex.equal_range(probe.hash);
+    for (auto it = first; it != last; ++it) {
+        if (record_same_key(pending[it->second], probe)) {
+            value = pending[it->second].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResultCache::insert(const Key& key, const Value& value) {
+    Record rec{key_hash(key), key, value};
+    std::unique_lock lock(mtx);
+
+    auto [first, last] = pendingIndex.equal_range(rec.hash);
+    for (auto it = first; it != last; ++it) {
+        if (record_same_key(pending[it->second], rec)) {
+            pending[it->second].value = value;
+            return;
+        }
+    }
+
+    pendingIndex.emplace(rec.hash, pending.size());
+    pending.push_back(rec);
+}
+
+bool ResultCache::flush() {
+    std::unique_lock lock(mtx);
+    if (pending.empty()) return true;
+
+    // pick up entries other processes added since we mapped the file
+    unmap_file();
+    map_file();
+
+    std::sort(pending.begin(), pending.end(), record_less);
+
+    std::vector<Record> merged;
+    merged.reserve(mappedCount + pending.size());
+    std::merge(mapped, mapped + mappedCount, pending.begin(), pending.end(), std::back_inserter(merged), record_less);
+    merged.erase(std::unique(merged.begin(), merged.end(), record_same_key), merged.end());
+
+    bool ok = write_file_atomic(path, [&](BinaryWriter& w) {
+        w.put(CACHE_MAGIC);
+        w.put<uint64_t>(merged.size());
+        if (!merged.empty()) w.ok = w.ok && std::fwrite(merged.data(), sizeof(Record), merged.size(), w.f) == merged.size();
+    });
+
+    if (ok) {
+        pending.clear();
+        pendingIndex.clear();
+    } else {
+        // keep pending entries; rebuild the index over the re-sorted vector
+        pendingIndex.clear();
+        for (std::size_t i = 0; i < pending.size(); ++i) pendingIndex.emplace(pending[i].hash, i);
+    }
+    unmap_file();
+    map_file();
+    return ok;
+}
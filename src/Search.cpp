@@ -0,0 +1,378 @@
+#include "ExperimentRunner.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric> // std::accumulate
+#include <queue>
+
+// ===== Time-Budgeted Search =====
+
+// Branch-and-bound over the tree of sequences whose shuffles fit in the time budget.
+// Every node is a candidate itself; its subtree is skipped when a lower bound on the
+// score of every extension is no better than the best sequence found so far. Nodes are
+// expanded best score first, SEARCH_BATCH at a time, and the search stops after
+// SEARCH_EVALUATIONS_MAX simulated sequences: once prefixes are mixed the bound below is
+// 0 and prunes nothing, so a large budget would otherwise simulate nearly every feasible
+// sequence.
+//
+// Lower bound: a short sequence fails by leaving original neighbours together (card c
+// directly above c + 1). A pair at any position survives one shuffle of model m with
+// probability at least s_m, so after any completion the expected number of pairs left is
+// at least (pairs now) x (smallest product of s_m the remaining time can buy), and every
+// surviving pair inflates its card's adjacency χ² row. Bounds are on expected scores and
+// use 3σ margins on simulated estimates - pruning is statistical, not exact.
+
+namespace {
+
+constexpr int TIME_UNITS_PER_SECOND = 100;  // costs and budget are compared in centiseconds
+constexpr int SURVIVAL_PILOT_TRIALS = 20000; // shuffles per model when estimating s_m
+constexpr double BOUND_SIGMAS = 3.0;
+constexpr int SEARCH_BATCH = 16;             // open nodes expanded per round, each up to 4 children
+
+int time_units(double seconds) {
+    return static_cast<int>(std::llround(seconds * TIME_UNITS_PER_SECOND));
+}
+
+// Original neighbours still together (c directly above c + 1)
+int preserved_pairs(const Deck& deck) {
+    int pairs = 0;
+    for (int i = 0; i < DECK_SIZE - 1; ++i) pairs += (deck[i + 1] == deck[i] + 1);
+    return pairs;
+}
+
+} // namespace
+
+// evaluate_sequence, plus a lower confidence bound on the original pairs left per trial
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_node(DeckContext& ctx, const std::vector<int>& idx, double& pairsLow) {
+    ctx.rng.seed(cfg.seed, sequence_code(idx)); // same stream as evaluate_sequence
+
+    double sum = 0, sumSq = 0;
+    for (int t = 0; t < cfg.trials; ++t) {
+        shuffle_trial(ctx, idx);
+        observe_trial(ctx);
+
+        const int pairs = preserved_pairs(ctx.deck);
+        sum += pairs;
+        sumSq += static_cast<double>(pairs) * pairs;
+    }
+
+    const double n = cfg.trials;
+    const double mean = sum / n;
+    const double var = n > 1 ? std::max(0.0, (sumSq - sum * mean) / (n - 1)) : 0.0;
+    pairsLow = std::max(0.0, mean - BOUND_SIGMAS * std::sqrt(var / n));
+
+    return summarise(ctx);
+}
+
+// Per allowed model: the smallest chance, over deck positions, that two adjacent cards
+// are still adjacent (same order) after one shuffle. Models act on positions only, so a
+// pilot from the sorted deck covers every deck. Drawn from stream 0, never a sequence code.
+std::vector<double> ExperimentRunner::pair_survival() {
+    DeckContext ctx;
+    ctx.rng.seed(cfg.seed, 0);
+
+    std::vector<double> survival;
+    for (Shuffle s : allowed) {
+        std::array<int, DECK_SIZE - 1> kept{};
+        std::array<uint8_t, DECK_SIZE> pos;
+
+        for (int t = 0; t < SURVIVAL_PILOT_TRIALS; ++t) {
+            ctx.reset();
+            apply_shuffle(ctx, s);
+            for (int i = 0; i < DECK_SIZE; ++i) pos[ctx.deck[i]] = i;
+            for (int c = 0; c < DECK_SIZE - 1; ++c) kept[c] += (pos[c + 1] == pos[c] + 1);
+        }
+
+        double lowest = 1.0;
+        for (int count : kept) {
+            const double p = static_cast<double>(count) / SURVIVAL_PILOT_TRIALS;
+            lowest = std::min(lowest, p - BOUND_SIGMAS * std::sqrt(p * (1 - p) / SURVIVAL_PILOT_TRIALS));
+        }
+        survival.push_back(std::max(0.0, lowest));
+    }
+    return survival;
+}
+
+ExperimentRunner::SearchOutcome ExperimentRunner::budget_search() {
+    const int base = static_cast<int>(allowed.size());
+    const int budget = time_units(cfg.timeBudget);
+
+    std::vector<int> cost(base);
+    for (int m = 0; m < base; ++m) cost[m] = time_units(cfg.timeCost[static_cast<int>(allowed[m])]);
+
+    SearchOutcome out;
+    out.bestScore = std::numeric_limits<double>::infinity();
+
+    // decay[b]: largest Σ -ln(s_m) over non-empty completions costing at most b
+    // (unbounded knapsack, -inf = nothing fits). exp(-decay[b]) is the survival floor.
+    const std::vector<double> survival = pair_survival();
+    std::vector<double> decay(budget + 1, -std::numeric_limits<double>::infinity());
+    for (int b = 0; b <= budget; ++b) {
+        for (int m = 0; m < base; ++m) {
+            if (cost[m] > b) continue;
+            const double rest = std::max(0.0, decay[b - cost[m]]);
+            decay[b] = std::max(decay[b], -std::log(survival[m]) + rest);
+        }
+    }
+
+    // Size of the exhaustive search: sequences of 1..SEARCH_K_MAX shuffles within budget
+    std::vector<double> ways(budget + 1, 0.0), next(budget + 1);
+    ways[0] = 1;
+    for (int len = 1; len <= SEARCH_K_MAX; ++len) {
+        std::fill(next.begin(), next.end(), 0.0);
+        for (int b = 0; b <= budget; ++b) {
+            if (ways[b] == 0) continue;
+            for (int m = 0; m < base; ++m) {
+                if (b + cost[m] <= budget) next[b + cost[m]] += ways[b];
+            }
+        }
+        ways.swap(next);
+        out.feasible = std::accumulate(ways.begin(), ways.end(), out.feasible);
+    }
+
+    // Mean adjacency χ² of T trials with `pairs` original neighbours left per deck is at
+    // least T (pairs - 51/52)² / 51 (the neighbour cells alone; 51/52 is the uniform rate)
+    constexpr double UNIFORM_PAIRS = (DECK_SIZE - 1.0) / DECK_SIZE;
+    auto subtree_bound = [&](double pairsLow, int left) {
+        const double pairs = pairsLow * std::exp(-decay[left]);
+        if (pairs <= UNIFORM_PAIRS) return 0.0;
+        const double d = pairs - UNIFORM_PAIRS;
+        return score_lower_bound(cfg.trials * d * d / (DECK_SIZE - 1));
+    };
+
+    struct Node {
+        std::vector<int> idx;
+        int time = 0; // centiseconds
+        SequenceResult result;
+        double pairsLow = 0;
+        double bound = 0;    // on every extension's score
+        uint64_t serial = 0; // evaluation order, breaks score ties
+    };
+
+    // Open nodes, lowest score first. Each round pops the SEARCH_BATCH best, simulates all
+    // their children together across the pool and pushes them in pop order - a fixed batch,
+    // not the pool's size, so the outcome is thread-count independent.
+    auto later = [](const Node& a, const Node& b) {
+        return a.result.score != b.result.score ? a.result.score > b.result.score : a.serial > b.serial;
+    };
+    std::priority_queue<Node, std::vector<Node>, decltype(later)> open(later);
+    open.push(Node{});
+
+    ThreadPool& pool = workers();
+
+    while (!open.empty() && out.complete) {
+        std::vector<Node> children;
+        for (int popped = 0; popped < SEARCH_BATCH && !open.empty();) {
+            const Node parent = open.top();
+            open.pop();
+            if (parent.bound >= out.bestScore) { // the incumbent improved since it was pushed
+                ++out.pruned;
+                continue;
+            }
+            if (static_cast<int>(parent.idx.size()) >= SEARCH_K_MAX) continue;
+
+            std::vector<Node> own;
+            for (int m = 0; m < base; ++m) {
+                if (parent.time + cost[m] > budget) continue;
+                Node child;
+                child.idx = parent.idx;
+                child.idx.push_back(m);
+                child.time = parent.time + cost[m];
+                own.push_back(std::move(child));
+            }
+            if (out.evaluated + children.size() + own.size() > SEARCH_EVALUATIONS_MAX) {
+                out.complete = false; // this round's other parents still run
+                break;
+            }
+            for (Node& child : own) children.push_back(std::move(child));
+            ++popped;
+        }
+
+        pool.parallel_for(children.size(), [&](std::size_t i) {
+            DeckContext ctx;
+            children[i].result = evaluate_node(ctx, children[i].idx, children[i].pairsLow);
+        });
+
+        for (Node& child : children) {
+            child.serial = out.evaluated++;
+            if (child.result.score < out.bestScore) {
+                out.bestScore = child.result.score;
+                out.bestSeqIdx = child.idx;
+                out.bestTime = static_cast<double>(child.time) / TIME_UNITS_PER_SECOND;
+            }
+        }
+
+        for (Node& child : children) {
+            const int left = budget - child.time;
+            if (decay[left] == -std::numeric_limits<double>::infinity()) continue; // leaf: nothing fits
+
+            child.bound = subtree_bound(child.pairsLow, left);
+            if (child.bound >= out.bestScore) {
+                ++out.pruned;
+                continue;
+            }
+            open.push(std::move(child));
+        }
+    }
+
+    if (!out.bestSeqIdx.empty()) {
+        evaluate_sequence(out.bestShuffledDeck, out.bestSeqIdx); // deterministic replay for the report
+    }
+    return out;
+}
+
+// ===== Beam Search =====
+
+// Sequences longer than an exhaustive sweep allows: keep the beamWidth best prefixes of
+// each length and extend each by every allowed shuffle. A prefix carries the decks its
+// trials ended on, so a child costs one shuffle per trial instead of a replay from the
+// sorted deck. The extra shuffle draws from the child's own stream, which keeps results
+// independent of beam order and thread count (but not identical to evaluate_sequence).
+ExperimentRunner::BeamOutcome ExperimentRunner::beam_search() {
+    const int base = static_cast<int>(allowed.size());
+
+    struct Prefix {
+        std::vector<int> idx;
+        std::vector<Deck> decks; // one per trial
+        SequenceResult result;
+    };
+
+    BeamOutcome out;
+    out.bestScore = std::numeric_limits<double>::infinity();
+
+    // Every trial starts from the sorted deck
+    std::vector<Prefix> beam(1);
+    beam[0].decks.assign(cfg.trials, CANONICAL_DECK);
+
+    ThreadPool& pool = workers();
+
+    for (int len = 1; len <= cfg.beamLength; ++len) {
+        std::vector<Prefix> children(beam.size() * base);
+
+        pool.parallel_for(children.size(), [&](std::size_t i) {
+            const Prefix& parent = beam[i / base];
+            const int m = static_cast<int>(i % base);
+            Prefix& child = children[i];
+
+            child.idx = parent.idx;
+            child.idx.push_back(m);
+
+            DeckContext ctx;
+            extend_decks(ctx, parent.decks, child.idx, child.decks);
+            for (const Deck& deck : child.decks) {
+                ctx.deck = deck;
+                observe_trial(ctx);
+            }
+            child.result = summarise(ctx);
+        });
+        out.evaluated += children.size();
+
+        // Survivors in score order - stable, so ties keep parent-then-shuffle order
+        std::stable_sort(children.begin(), children.end(), [](const Prefix& a, const Prefix& b) {
+            return a.result.score < b.result.score;
+        });
+        if (children.size() > static_cast<std::size_t>(cfg.beamWidth)) children.resize(cfg.beamWidth);
+
+        const Prefix& best = children.front();
+        out.levels.push_back({best.idx, best.result.score});
+
+        if (best.result.score < out.bestScore) {
+            out.bestScore = best.result.score;
+            out.bestSeqIdx = best.idx;
+
+            // Observation is deterministic, so the report's accumulators are rebuilt from the decks
+            out.bestShuffledDeck = DeckContext{};
+            for (const Deck& deck : best.decks) {
+                out.bestShuffledDeck.deck = deck;
+                observe_trial(out.bestShuffledDeck);
+            }
+            out.bestShuffledDeck.numShuffles = cfg.trials * len;
+        }
+
+        beam = std::move(children);
+    }
+
+    return out;
+}
+
+// ===== Shared-Prefix Evaluation =====
+
+// The beam's trial scheme applied to the whole sweep (--share-prefixes). Sequences of one
+// length never match in distribution under these statistics - a cut prefix relabels each
+// trial's cards differently, which changes every aggregated table - so the saving comes
+// from common prefixes instead: a group of n^depth sequences with the same first k - depth
+// shuffles simulates (k - depth) + n + n^2 + ... + n^depth shuffles per trial, not k n^depth.
+// Sequences sharing a prefix share its randomness (common random numbers), which makes
+// comparisons between them sharper without biasing any one of them.
+
+// to[t] = from[t] after the last shuffle of idx, drawn from idx's stream (from may be to)
+void ExperimentRunner::extend_decks(DeckContext& ctx, const std::vector<Deck>& from, const std::vector<int>& idx, std::vector<Deck>& to) {
+    ctx.rng.seed(cfg.seed, sequence_code(idx));
+    to.resize(from.size());
+    for (std::size_t t = 0; t < from.size(); ++t) {
+        ctx.deck = from[t];
+        apply_shuffle(ctx, allowed[idx.back()]);
+        to[t] = ctx.deck;
+    }
+}
+
+// One sequence under the shared scheme (replays of the sweep's best)
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_shared(DeckContext& ctx, const std::vector<int>& idx) {
+    std::vector<Deck> decks(cfg.trials, CANONICAL_DECK);
+    std::vector<int> prefix;
+    for (int i : idx) {
+        prefix.push_back(i);
+        extend_decks(ctx, decks, prefix, decks);
+    }
+
+    for (const Deck& deck : decks) {
+        ctx.deck = deck;
+        observe_trial(ctx);
+    }
+    ctx.numShuffles = cfg.trials * static_cast<int>(idx.size());
+    return summarise(ctx);
+}
+
+// The n^depth sequences from firstRank (which must start a group) into out, in rank order
+void ExperimentRunner::evaluate_group(uint64_t firstRank, int depth, SequenceResult* out) {
+    const int base = static_cast<int>(allowed.size());
+
+    std::vector<int> idx = sequence_from_rank(firstRank, cfg.kMax, base);
+    idx.resize(cfg.kMax - depth);
+
+    DeckContext ctx;
+    std::vector<std::vector<Deck>> levels(depth + 1);
+    levels[0].assign(cfg.trials, CANONICAL_DECK);
+    std::vector<int> prefix;
+    for (int i : idx) {
+        prefix.push_back(i);
+        extend_decks(ctx, levels[0], prefix, levels[0]);
+    }
+
+    std::size_t slot = 0;
+    std::function<void(int)> descend = [&](int level) {
+        for (int m = 0; m < base; ++m) {
+            idx.push_back(m);
+            extend_decks(ctx, levels[level], idx, levels[level + 1]);
+
+            if (level + 1 == depth) {
+                DeckContext acc;
+                for (const Deck& deck : levels[depth]) {
+                    acc.deck = deck;
+                    observe_trial(acc);
+                }
+                acc.numShuffles = cfg.trials * cfg.kMax;
+                out[slot] = summarise(acc);
+                out[slot].rank = firstRank + slot;
+                ++slot;
+            } else {
+                descend(level + 1);
+            }
+            idx.pop_back();
+        }
+    };
+    descend(0);
+}
@@ -0,0 +1,395 @@
+#include "Server.h"
+#include "ExperimentRunner.h"
+#include "Json.h"
+#include "Manifest.h"
+#include "ResultCache.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t REQUEST_MAX = 1 << 20; // bytes per request line
+constexpr std::size_t SCORE_SEQUENCES_MAX = 100000;
+constexpr int CONNECTIONS_MAX = 64;
+constexpr int POLL_MS = 200; // how soon a stop is noticed
+
+volatile std::sig_atomic_t stopSignal = 0;
+void request_stop(int) { stopSignal = 1; }
+
+// Warm state shared by every connection
+struct Daemon {
+    ThreadPool pool;
+    ResultCache cache; // thread-safe
+    Clock::time_point start = Clock::now();
+    std::atomic<bool> stopping{false}; // shutdown request
+    std::atomic<uint64_t> requests{0};
+    std::atomic<int> connections{0};
+
+    explicit Daemon(const ServerOptions& options) : pool(options.threads), cache(options.cachePath) {}
+
+    bool stopped() const { return stopping || stopSignal; }
+};
+
+const char* shuffle_name(Shuffle s) {
+    switch (s) {
+        case Shuffle::Cut:      return "cut";
+        case Shuffle::Riffle:   return "riffle";
+        case Shuffle::Hindu:    return "hindu";
+        case Shuffle::Overhand: return "overhand";
+        default:                return "random";
+    }
+}
+
+bool parse_shuffle(const JsonValue& v, Shuffle& out) {
+    if (!v.is_string()) return false;
+    for (Shuffle s : {Shuffle::Cut, Shuffle::Riffle, Shuffle::Hindu, Shuffle::Overhand}) {
+        if (v.string == shuffle_name(s)) { out = s; return true; }
+    }
+    return false;
+}
+
+// One sequence's statistics (null for a disabled test)
+void write_result(std::ostream& os, const std::vector<Shuffle>& seq, const ExperimentRunner::SequenceResult& r) {
+    os << "{\"sequence\":[";
+    for (std::size_t i = 0; i < seq.size(); ++i) os << (i ? "," : "") << '"' << shuffle_name(seq[i]) << '"';
+    os << "],\"score\":" << r.score;
+
+    const std::pair<const char*, double> stats[] = {
+        {"uniformity", r.uniformity}, {"adjacency", r.adjacency}, {"mixing", r.displacement}, {"poker", r.poker}};
+    for (const auto& [name, value] : stats) {
+        os << ",\"" << name << "\":";
+        if (value == -1) os << "null";
+        else             os << value;
+    }
+    os << '}';
+}
+
+// The request's experiment keys on top of the --run defaults (seed 0)
+bool read_experiment(const JsonValue& req, std::initializer_list<const char*> opKeys,
+                     ExperimentRunner::ExperimentConfig& cfg, std::string& err) {
+    cfg.kMax = 5;
+    cfg.trials = 50;
+    cfg.testUniformity = cfg.testAdjacency = cfg.testMixing = true;
+
+    JsonValue keys;
+    keys.type = JsonValue::Type::Object;
+    for (const auto& [key, v] : req.object) {
+        if (key == "op" || key == "id") continue;
+        if (std::any_of(opKeys.begin(), opKeys.end(), [&](const char* k) { return key == k; })) continue;
+        if (key == "name") {
+            err = "unknown key \"name\"";
+            return false;
+        }
+        keys.object.emplace_back(key, v);
+    }
+
+    std::string name;
+    bool sawSeed = false;
+    return apply_experiment_keys(keys, cfg, name, sawSeed, err) && check_experiment(cfg, err);
+}
+
+// {"sequences": [[names...], ...]} - given sequences of any length, results in request order
+bool op_score(Daemon& d, const JsonValue& req, std::ostream& os, std::string& err) {
+    if (req.find("k") || req.find("shuffles")) {
+        err = "\"k\" and \"shuffles\" apply to best requests (score takes whole sequences)";
+        return false;
+    }
+
+    const JsonValue* list = req.find("sequences");
+    if (!list || !list->is_array() || list->array.empty() || list->array.size() > SCORE_SEQUENCES_MAX) {
+        err = "\"sequences\" must be a list of 1 to " + std::to_string(SCORE_SEQUENCES_MAX) + " sequences";
+        return false;
+    }
+
+    std::vector<std::vector<Shuffle>> seqs;
+    seqs.reserve(list->array.size());
+    for (const JsonValue& s : list->array) {
+        if (!s.is_array() || s.array.empty() || s.array.size() > ExperimentRunner::SEARCH_K_MAX) {
+            err = "each sequence must list 1 to " + std::to_string(ExperimentRunner::SEARCH_K_MAX) +
+                  " of cut, riffle, hindu or overhand";
+            return false;
+        }
+        std::vector<Shuffle> seq(s.array.size());
+        for (std::size_t i = 0; i < seq.size(); ++i) {
+            if (!parse_shuffle(s.array[i], seq[i])) {
+                err = "each sequence must list 1 to " + std::to_string(ExperimentRunner::SEARCH_K_MAX) +
+                      " of cut, riffle, hindu or overhand";
+                return false;
+            }
+        }
+        seqs.push_back(std::move(seq));
+    }
+
+    ExperimentRunner::ExperimentConfig cfg;
+    if (!read_experiment(req, {"sequences"}, cfg, err)) return false;
+
+    ExperimentRunner runner(cfg);
+    runner.share(&d.pool, &d.cache);
+    uint64_t reused = 0;
+    const std::vector<ExperimentRunner::SequenceResult> results = runner.evaluate_batch(seqs, reused);
+
+    os << ",\"results\":[";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (i) os << ',';
+        write_result(os, seqs[i], results[i]);
+    }
+    os << "],\"simulated\":" << results.size() - reused << ",\"reused\":" << reused;
+    return true;
+}
+
+// {"k": 5, "shuffles": [...], "top": 3} - a sweep of every sequence of length k, best first
+bool op_best(Daemon& d, const JsonValue& req, std::ostream& os, std::string& err) {
+    int top = 1;
+    if (const JsonValue* t = req.find("top")) {
+        if (!t->is_number() || !(t->number >= 1) || t->number > ExperimentRunner::TOP_MAX || t->number != std::floor(t->number)) {
+            err = "\"top\" must be between 1 and " + std::to_string(ExperimentRunner::TOP_MAX);
+            return false;
+        }
+        top = static_cast<int>(t->number);
+    }
+
+    ExperimentRunner::ExperimentConfig cfg;
+    if (!read_experiment(req, {"top"}, cfg, err)) return false;
+    cfg.top = top;
+
+    ExperimentRunner runner(cfg);
+    runner.share(&d.pool, &d.cache);
+    const ExperimentRunner::SweepOutcome sweep = runner.sweep();
+
+    os << ",\"results\":[";
+    const auto& ranked = sweep.rankings.byScore;
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+        if (i) os << ',';
+        const std::vector<int> idx = ExperimentRunner::sequence_from_rank(ranked[i].rank, cfg.kMax, runner.num_shuffles());
+        write_result(os, runner.shuffles_of(idx), ranked[i]);
+    }
+    os << "],\"sequences\":" << sweep.sequences << ",\"simulated\":" << sweep.cacheMisses
+       << ",\"reused\":" << sweep.cacheHits;
+    return true;
+}
+
+// Response line for one request line
+std::string handle_request(Daemon& d, const std::string& line) {
+    const auto start = Clock::now();
+    std::ostringstream body;
+    body << std::setprecision(17);
+    std::string err;
+
+    JsonValue req;
+    std::string op, id;
+    bool ok = parse_json(line, req, err);
+    if (ok && !req.is_object()) {
+        err = "a request must be an object with an \"op\"";
+        ok = false;
+    }
+    if (ok) {
+        // echoed so clients can match pipelined responses
+        if (const JsonValue* v = req.find("id")) {
+            std::ostringstream idText;
+            idText << std::setprecision(17);
+            if (v->is_string())      idText << '"' << json_escape(v->string) << '"';
+            else if (v->is_number()) idText << v->number;
+            else {
+                err = "\"id\" must be a string or number";
+                ok = false;
+            }
+            id = idText.str();
+        }
+    }
+    if (ok) {
+        op = req.string_or("op", "");
+        if (op == "score") {
+            ok = op_score(d, req, body, err);
+        } else if (op == "best") {
+            ok = op_best(d, req, body, err);
+        } else if (op == "status") {
+            body << ",\"uptime\":" << std::chrono::duration<double>(Clock::now() - d.start).count()
+                 << ",\"requests\":" << d.requests << ",\"connections\":" << d.connections
+                 << ",\"threads\":" << d.pool.size() << ",\"cache_entries\":" << d.cache.size();
+        } else if (op == "shutdown") {
+            d.stopping = true;
+        } else if (op != "ping") {
+            err = op.empty() ? "missing \"op\" (score, best, status, ping or shutdown)" : "unknown op \"" + op + "\"";
+            ok = false;
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\"ok\":" << (ok ? "true" : "false");
+    if (!id.empty()) out << ",\"id\":" << id;
+    if (!ok) {
+        out << ",\"error\":\"" << json_escape(err) << "\"}";
+        return out.str();
+    }
+    out << ",\"op\":\"" << op << '"' << body.str() << ",\"ms\":" << std::fixed << std::setprecision(3)
+        << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << '}';
+    return out.str();
+}
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL); // closed peer: error, not SIGPIPE
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Request lines in, response lines out, until the client hangs up or the daemon stops
+void serve_connection(Daemon& d, int fd) {
+    std::string buffer;
+    char chunk[65536];
+
+    while (!d.stopped()) {
+        pollfd p{fd, POLLIN, 0};
+        const int ready = poll(&p, 1, POLL_MS);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+
+        const ssize_t got = recv(fd, chunk, sizeof chunk, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        buffer.append(chunk, static_cast<std::size_t>(got));
+
+        std::size_t consumed = 0, newline;
+        bool open = true;
+        while (open && (newline = buffer.find('\n', consumed)) != std::string::npos) {
+            std::string line = buffer.substr(consumed, newline - consumed);
+            consumed = newline + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos) continue;
+
+            ++d.requests;
+            open = send_all(fd, handle_request(d, line) + "\n");
+        }
+        buffer.erase(0, consumed);
+        if (!open) break;
+
+        if (buffer.size() > REQUEST_MAX) {
+            send_all(fd, "{\"ok\":false,\"error\":\"request line longer than " + std::to_string(REQUEST_MAX) + " bytes\"}\n");
+            break;
+        }
+    }
+    close(fd);
+}
+
+// Listening socket at path, replacing a stale one left by a daemon that did not exit cleanly
+int open_socket(const std::string& path, std::string& err) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        err = "socket path must be 1 to " + std::to_string(sizeof(addr.sun_path) - 1) + " characters";
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            err = path + " exists and is not a socket";
+            return -1;
+        }
+        const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool live = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof addr) == 0;
+        if (probe >= 0) close(probe);
+        if (live) {
+            err = "a daemon is already listening on " + path;
+            return -1;
+        }
+        unlink(path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0 || listen(fd, CONNECTIONS_MAX) != 0) {
+        err = "could not listen on " + path + ": " + std::strerror(errno);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+bool serve(const ServerOptions& options, std::string& err) {
+    const int listenFd = open_socket(options.socketPath, err);
+    if (listenFd < 0) return false;
+
+    Daemon d(options);
+    std::cout << "Serving on " << options.socketPath << " - threads: " << d.pool.size() << ", cache: "
+              << (options.cachePath.empty() ? "in memory" : options.cachePath) << " (" << d.cache.size()
+              << " entries)" << std::endl;
+
+    stopSignal = 0;
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    struct Connection {
+        std::thread thread;
+        std::atomic<bool> done{false};
+    };
+    std::list<Connection> connections;
+
+    while (!d.stopped()) {
+        // join connections that have ended
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (!it->done) { ++it; continue; }
+            it->thread.join();
+            it = connections.erase(it);
+        }
+
+        pollfd p{listenFd, POLLIN, 0};
+        if (poll(&p, 1, POLL_MS) <= 0) continue;
+
+        const int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        if (static_cast<int>(connections.size()) >= CONNECTIONS_MAX) {
+            send_all(fd, "{\"ok\":false,\"error\":\"too many connections\"}\n");
+            close(fd);
+            continue;
+        }
+
+        Connection& c = connections.emplace_back();
+        ++d.connections;
+        c.thread = std::thread([&d, &c, fd] {
+            serve_connection(d, fd);
+            --d.connections;
+            c.done = true;
+        });
+    }
+
+    // In-flight requests finish, then every connection closes
+    close(listenFd);
+    unlink(options.socketPath.c_str());
+    for (Connection& c : connections) c.thread.join();
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+
+    if (!options.cachePath.empty() && !d.cache.flush()) {
+        std::cerr << "warning: failed to write cache " << options.cachePath << "\n";
+    }
+    std::cout << "Stopped after " << d.requests << " requests (" << d.cache.size() << " cache entries)" << std::endl;
+    return true;
+}
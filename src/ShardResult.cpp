@@ -0,0 +1,106 @@
+#include "ShardResult.h"
+#include "BinaryIO.h"
+
+#include <algorithm>
+#include <cstring> // memcmp
+
+static constexpr char SHARD_MAGIC[8] = {'S', 'L', 'S', 'H', 'R', 'D', '0', '4'};
+
+bool save_shard_result(const std::string& path, const ShardResult& r) {
+    return write_file_atomic(path, [&](BinaryWriter& w) {
+        w.put(SHARD_MAGIC);
+
+        put_experiment(w, r.cfg);
+
+        w.put_vec(r.results);
+
+        w.put_vec(r.bestSeqIdx);
+        w.put(r.bestScore);
+        put_context(w, r.bestShuffledDeck);
+    });
+}
+
+bool load_shard_result(const std::string& path, ShardResult& r) {
+    return read_file(path, [&](BinaryReader& rd) {
+        char magic[8] = {};
+        rd.get(magic);
+        if (!rd.ok || std::memcmp(magic, SHARD_MAGIC, sizeof(magic)) != 0) {
+            rd.ok = false;
+            return;
+        }
+
+        get_experiment(rd, r.cfg);
+
+        rd.get_vec(r.results, uint64_t(1) << (3 * ExperimentRunner::K_MAX));
+
+        rd.get_vec(r.bestSeqIdx, ExperimentRunner::K_MAX);
+        rd.get(r.bestScore);
+        get_context(rd, r.bestShuffledDeck);
+    });
+}
+
+bool merge_shard_results(const std::vector<ShardResult>& shards, int base, ShardResult& merged, std::string& err) {
+    if (shards.empty()) {
+        err = "no shard files given";
+        return false;
+    }
+
+    const auto& ref = shards[0].cfg;
+    const int n = ref.shardCount;
+
+    // Every shard must come from the same experiment and appear exactly once
+    std::vector<bool> seen(n, false);
+    for (const ShardResult& s : shards) {
+        const auto& c = s.cfg;
+        if (!ExperimentRunner::same_experiment(c, ref) || c.shardCount != n) {
+            err = "shard files come from different experiments";
+            return false;
+        }
+        if (seen[c.shardIndex]) {
+            err = "shard " + std::to_string(c.shardIndex) + "/" + std::to_string(n) + " given twice";
+            return false;
+        }
+        seen[c.shardIndex] = true;
+
+        const auto [begin, end] = ExperimentRunner::shard_range(c, base);
+        if (s.results.size() != end - begin) {
+            err = "shard " + std::to_string(c.shardIndex) + "/" + std::to_string(n) + " is incomplete";
+            return false;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!seen[i]) {
+            err = "missing shard " + std::to_string(i) + "/" + std::to_string(n);
+            return false;
+        }
+    }
+
+    merged = ShardResult{};
+    merged.cfg = ref;
+    merged.cfg.shardIndex = 0;
+    merged.cfg.shardCount = 1;
+
+    const ShardResult* best = nullptr;
+    for (const ShardResult& s : shards) {
+        merged.results.insert(merged.results.end(), s.results.begin(), s.results.end());
+
+        if (s.bestSeqIdx.empty()) continue;
+        const uint64_t rank = ExperimentRunner::sequence_rank(s.bestSeqIdx, base);
+        if (!best || s.bestScore < best->bestScore ||
+            (s.bestScore == best->bestScore && rank < ExperimentRunner::sequence_rank(best->bestSeqIdx, base))) {
+            best = &s;
+        }
+    }
+
+    std::sort(merged.results.begin(), merged.results.end(),
+        [](const ExperimentRunner::SequenceResult& a, const ExperimentRunner::SequenceResult& b) {
+            return a.score != b.score ? a.score < b.score : a.rank < b.rank;
+        });
+
+    if (best) {
+        merged.bestSeqIdx = best->bestSeqIdx;
+        merged.bestScore = best->bestScore;
+        merged.bestShuffledDeck = best->bestShuffledDeck;
+    }
+    return true;
+}
@@ -1,15 +1,66 @@
 #include "Deck.h"
 // Implementation File for Deck.h
 
+// ===== Model Parameters =====
+
+// Bump when a shuffle kernel changes behaviour without a parameter change (invalidates cached results)
+static constexpr uint64_t MODEL_VERSION = 1;
+
+// create_cdf(min, max, centre, spread) per table, indexed by ModelTable (fit with --calibrate)
+static constexpr std::array<CdfParams, MODEL_TABLES> DEFAULT_PARAMS = {{
+    {5, 47, 26, 5},     // Cut
+    {12, 40, 26, 3.6},  // Riffle: split into two packets - binomial approximation for now
+    {1, 5, 2, 1.2},     // Hindu: packet pickups per shuffle - more variance shuffle-to-shuffle -> more trials
+    {20, 50, 35, 9},    // Hindu: cards taken off the top per pickup (larger = more random cut) - to be observed
+    {2, 10, 5, 2.5},    // Hindu: cards dropped from the packet at a time - to be observed, gives count not idx
+    {20, 26, 31, 4},    // Overhand: cards taken off the top per pickup - to be observed
+    {2, 10, 5, 2.5},    // Overhand: cards dropped at a time - to be observed, gives count not idx
+}};
+
+static const auto default_tables = []{ // std::exp not constexpr
+    std::array<CdfTable, MODEL_TABLES> tables{};
+    for (int t = 0; t < MODEL_TABLES; ++t) {
+        const CdfParams& p = DEFAULT_PARAMS[t];
+        tables[t] = create_cdf(p.min, p.max, p.centre, p.spread);
+    }
+    return tables;
+}();
+
+const ShuffleModel& default_model() noexcept {
+    static const ShuffleModel model = []{
+        ShuffleModel m;
+        for (int t = 0; t < MODEL_TABLES; ++t) m.tables[t] = &default_tables[t];
+        return m;
+    }();
+    return model;
+}
+
+CdfParams default_params(ModelTable t) noexcept {
+    return DEFAULT_PARAMS[static_cast<int>(t)];
+}
+
+// FNV-1a over every model table - changes whenever any create_cdf parameter does
+uint64_t model_fingerprint() noexcept {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](uint64_t v) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (v >> (8 * b)) & 0xff;
+            h *= 1099511628211ULL;
+        }
+    };
+
+    mix(MODEL_VERSION);
+    for (const CdfTable& cdf : default_tables) {
+        for (uint16_t c : cdf) mix(c);
+    }
+    return h;
+}
+
 // ===== Human Shuffles =====
 
 // Simple Cut (Custom)
 void DeckContext::cut() noexcept {
-    static auto cut_cdf = []{ // std::exp not constexpr
-        return create_cdf(5, 47, 26, 5); 
-    }();
-
-    uint8_t cutPoint = rng.sample_cdf(cut_cdf);
+    uint8_t cutPoint = sample(ModelTable::Cut);
 
     perfect_cut(cutPoint);
 
@@ -17,11 +68,11 @@ void DeckContext::cut() noexcept {
 
 // GSR Riffle Model
 void DeckContext::riffle() noexcept {
-    static auto riffle_cdf = []{ // used for getting two packets
-        return create_cdf(12, 40, 26, 3.6); // Binomial approximation for now
-    }();
-
-    uint8_t cutPoint = rng.sample_cdf(riffle_cdf); // split deck into two packets
+    uint8_t cutPoint = sample(ModelTable::Riffle); // split deck into two packets
+    if (tilt) [[unlikely]] {
+        tilted_interleave(cutPoint);
+        return;
+    }
 
     // packet 1 (L) Deck [0, cutPoint), packet 2 (R) Deck [cutPoint, DECK_SIZE)
     int L = cutPoint, R = DECK_SIZE - cutPoint; // num card left in each packet
@@ -57,28 +108,14 @@ void DeckContext::riffle() noexcept {
 
 // Hindu Shuffle (Custom)
 void DeckContext::hindu() noexcept {
-    // determines number of packet pickups per shuffle
-    static auto hindu_num_ops = []{ // more variance shuffle-to-shuffle -> more trials
-        return create_cdf(1, 5, 2, 1.2);
-    }();
-
-    // determines number of cards taken off of top for every removal //larrger more random cut
-    static auto hindu_cut_cdf = []{
-        return create_cdf(20, 50, 35, 9); // to be observed
-    }();
-
-    // determines num cards dropped from top of packet at a time
-    static auto hindu_drop_cdf = []{
-        return create_cdf(2, 10, 5, 2.5); // to be observed - as defined gives count not idx
-    }();
-
-
-    auto numOps = rng.sample_cdf(hindu_num_ops);
+    const CdfTable& cutCdf = model->table(ModelTable::HinduCut); // hoisted - deck stores may alias
+    const CdfTable& dropCdf = model->table(ModelTable::HinduDrop);
+    auto numOps = sample(ModelTable::HinduOps);
 
     buffer = deck; // subsequent operations guarantee this condition afterwards
     for (int i = 0; i < numOps; ++i) {
         
-        int cutPoint = rng.sample_cdf(hindu_cut_cdf); // idx of bottom of packet
+        int cutPoint = sample(ModelTable::HinduCut, cutCdf); // idx of bottom of packet
 
         int n = cutPoint; // buffer ptr
 
@@ -88,7 +125,7 @@ void DeckContext::hindu() noexcept {
 
         while (n >= 0) {
             
-            int dropCount = rng.sample_cdf(hindu_drop_cdf); // always > 0
+            int dropCount = sample(ModelTable::HinduDrop, dropCdf); // always > 0
             int dropPoint = std::min(cutPoint, dropped + dropCount - 1); // bottom card of sub-packet idx
 
 
@@ -111,18 +148,9 @@ void DeckContext::hindu() noexcept {
 
 // Overhand Shuffle (Custom)
 void DeckContext::overhand() noexcept {
-    // determines number of cards taken off of top for every removal //larrger more random cut
-    static auto overhand_cut_cdf = []{
-        return create_cdf(20, 26, 31, 4); // to be observed
-    }();
-
-    // determines num cards dropped from top of packet at a time
-    static auto overhand_drop_cdf = []{
-        return create_cdf(2, 10, 5, 2.5); // to be observed - as defined gives count not idx
-    }();
-
     // take packet from bottom [0, cutPoint)
-    int cutPoint = rng.sample_cdf(overhand_cut_cdf);
+    const CdfTable& dropCdf = model->table(ModelTable::OverhandDrop);
+    int cutPoint = sample(ModelTable::OverhandCut);
 
     buffer = deck; // could maybe be optimised by only copying necessary cards
 
@@ -131,7 +159,7 @@ void DeckContext::overhand() noexcept {
 
     while (n >= 0) {
             
-            int dropCount = rng.sample_cdf(overhand_drop_cdf); // > 0
+            int dropCount = sample(ModelTable::OverhandDrop, dropCdf); // > 0
             int dropPoint = std::min(cutPoint, dropped + dropCount - 1); // bottom card of sub-packet idx
 
 
@@ -160,11 +188,39 @@ void DeckContext::random_test_shuffle() noexcept {
     }
 }
 
+// ===== Game Cycle Collection =====
+
+// Gathering the cards after a Hold'em hand (layout as DeckContext::observe_poker):
+// the undealt stub stays on top, folded hands land on it as two-card piles in a
+// random order, then the burn cards and the board go on as one clump
+void DeckContext::collect_piles(int seats) noexcept {
+    const int b = 2 * seats; // first card after the hole cards
+    int n = 0;
+
+    for (int i = b + 8; i < DECK_SIZE; ++i) buffer[n++] = deck[i];
+
+    std::array<uint8_t, POKER_MAX_SEATS> foldOrder{};
+    for (int s = 0; s < seats; ++s) {
+        int j = rng.random_bounded(s + 1);
+        foldOrder[s] = foldOrder[j];
+        foldOrder[j] = s;
+    }
+    for (int i = 0; i < seats; ++i) {
+        buffer[n++] = deck[foldOrder[i]];
+        buffer[n++] = deck[seats + foldOrder[i]];
+    }
+
+    for (int pos : {b, b + 4, b + 6}) buffer[n++] = deck[pos];              // burns
+    for (int pos : {b + 1, b + 2, b + 3, b + 5, b + 7}) buffer[n++] = deck[pos]; // board
+
+    deck = buffer;
+}
+
 // ===== Perfect Shuffles =====
 
 
 // Perfect Cut (half by default)
-inline void DeckContext::perfect_cut(uint8_t cutPoint) noexcept {
+void DeckContext::perfect_cut(uint8_t cutPoint) noexcept {
 
     int n = 0;
 
@@ -180,7 +236,7 @@ inline void DeckContext::perfect_cut(uint8_t cutPoint) noexcept {
 }
 
 // Perfect Riffle (Faro)
-inline void DeckContext::perfect_riffle() noexcept {
+void DeckContext::perfect_riffle() noexcept {
 
     perfect_cut(); // buffer now holds cut;
     int n = 0; // buffer incrementor
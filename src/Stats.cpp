@@ -1,4 +1,7 @@
 #include "Deck.h"
+#include "HandEvaluator.h"
+
+#include <algorithm> // std::max
 // Implementation File for Deck.h
 
 // ===== Shuffle Stat Tests =====
@@ -42,6 +45,63 @@ void DeckContext::observe_displacement() noexcept {
     }
 }
 
+// Same, measured from each card's position in before (the deck as collected, not sorted)
+void DeckContext::observe_displacement(const Deck& before) noexcept {
+    std::array<uint8_t, DECK_SIZE> from;
+    for (int pos = 0; pos < DECK_SIZE; ++pos) from[before[pos]] = pos;
+
+    for (int pos = 0; pos < DECK_SIZE; ++pos) {
+        int d = std::abs(pos - from[deck[pos]]);
+        ++dispHist[d];
+    }
+}
+
+// ===== Hold'em Deal (Real-Game Bias) =====
+
+// Question Answered: “Does the shuffle favour a seat or a kind of hand when dealt?”
+// Test Used: Chi-Squared (hand classes per seat, pot share per seat), Data: Class & Equity Tallies
+// Deal from the top: two hole cards round-robin, then burn-flop, burn-turn, burn-river
+void DeckContext::observe_poker(int seats) noexcept {
+    add_poker_deal(deal_poker(seats), seats);
+}
+
+PokerDeal DeckContext::deal_poker(int seats) const noexcept {
+    const int b = 2 * seats; // first card after the hole cards
+
+    PartialHand board;
+    for (int pos : {b + 1, b + 2, b + 3, b + 5, b + 7}) board.add(deck[pos]);
+
+    PokerDeal deal;
+    std::array<HandStrength, POKER_MAX_SEATS> strength{};
+    HandStrength best = 0;
+    for (int seat = 0; seat < seats; ++seat) {
+        PartialHand hand = board;
+        hand.add(deck[seat]);
+        hand.add(deck[seats + seat]);
+        strength[seat] = hand.evaluate();
+        best = std::max(best, strength[seat]);
+        deal.handClass[seat] = hand_class(strength[seat]);
+    }
+
+    for (int seat = 0; seat < seats; ++seat) {
+        if (strength[seat] == best) deal.winners |= 1u << seat;
+    }
+    return deal;
+}
+
+void DeckContext::add_poker_deal(const PokerDeal& deal, int seats) noexcept {
+    int winners = 0;
+    for (int seat = 0; seat < seats; ++seat) {
+        ++pokerClassFreq[seat][deal.handClass[seat]];
+        winners += (deal.winners >> seat) & 1;
+    }
+
+    const double share = 1.0 / winners;
+    for (int seat = 0; seat < seats; ++seat) {
+        if ((deal.winners >> seat) & 1) pokerEquity[seat] += share;
+    }
+    ++pokerDeals;
+}
 
 // ===== WIP =====
 
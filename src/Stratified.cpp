@@ -0,0 +1,102 @@
+#include "ExperimentRunner.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+// ===== Stratified Trials =====
+
+// A sequence's score moves most with each shuffle's first draw - where the cut falls,
+// how evenly the riffle splits, how many hindu pickups, how big the overhand packet.
+// With --stratify those draws are Latin-hypercube sampled: for every step, the trials
+// split [0, 1) into cfg.trials equal strata, a random permutation hands each trial one,
+// and the trial's draw is taken at a random point inside it. Each trial's draws keep the
+// model's distribution, but no stratum of any step is missed or doubled by chance. The
+// interleaves and packet drops inside a shuffle stay independent.
+
+static constexpr uint64_t STRATIFY_CHECK_SEED_MIX = 0xA0761D6478BD642Full; // replicate seeds != the run's
+
+ExperimentRunner::SequenceResult ExperimentRunner::evaluate_stratified(DeckContext& ctx, const std::vector<int>& idx) {
+    ctx.rng.seed(cfg.seed, sequence_code(idx));
+
+    const int steps = static_cast<int>(idx.size());
+    const int trials = cfg.trials;
+
+    // strata[s * trials + t]: stratum of step s's leading draw in trial t
+    std::vector<uint16_t> strata(static_cast<std::size_t>(steps) * trials);
+    for (int s = 0; s < steps; ++s) {
+        uint16_t* perm = &strata[static_cast<std::size_t>(s) * trials];
+        std::iota(perm, perm + trials, 0);
+        for (int i = trials - 1; i > 0; --i) std::swap(perm[i], perm[ctx.rng.random_bounded(i + 1)]);
+    }
+
+    constexpr double JITTER_SCALE = 1.0 / (1u << 24);
+    for (int t = 0; t < trials; ++t) {
+        ctx.reset();
+        for (int s = 0; s < steps; ++s) {
+            const double jitter = (ctx.rng.random_bounded(1u << 24) + 0.5) * JITTER_SCALE;
+            ctx.quantile = (strata[static_cast<std::size_t>(s) * trials + t] + jitter) / trials;
+            apply_shuffle(ctx, allowed[idx[s]]);
+            ctx.quantile = -1; // a shuffle that draws nothing leaves it set
+        }
+        observe_trial(ctx);
+    }
+
+    return summarise(ctx);
+}
+
+// The check_sequences (STRATIFY_CHECK_SEQUENCES), each scored under
+// STRATIFY_CHECK_REPLICATES seeds with independent and with stratified trials. The ratio of the two score variances is how many independent
+// trials a stratified one is worth (its effective sample size per trial).
+ExperimentRunner::StratifyCheck ExperimentRunner::check_stratify(const std::vector<int>& bestSeqIdx) {
+    const std::vector<std::vector<int>> seqs = check_sequences(bestSeqIdx, STRATIFY_CHECK_SEQUENCES);
+    ThreadPool& pool = workers();
+
+    // scores[scheme][seq * R + r], scheme 0 = independent, 1 = stratified - each task runs
+    // on a copy of the runner so the seed and scheme can differ between tasks
+    constexpr int R = STRATIFY_CHECK_REPLICATES;
+    std::array<std::vector<double>, 2> scores;
+    for (auto& v : scores) v.resize(seqs.size() * R);
+
+    pool.parallel_for(2 * seqs.size() * R, [&](std::size_t task) {
+        const std::size_t scheme = task / (seqs.size() * R);
+        const std::size_t slot = task % (seqs.size() * R);
+
+        ExperimentConfig replicate = cfg;
+        replicate.stratify = scheme == 1;
+        replicate.seed = cfg.seed ^ STRATIFY_CHECK_SEED_MIX ^ (0x9E3779B97F4A7C15ull * (slot % R + 1));
+        replicate.threads = 1;
+        ExperimentRunner runner(replicate);
+
+        DeckContext ctx;
+        scores[scheme][slot] = runner.evaluate_sequence(ctx, seqs[slot / R]).score;
+    });
+
+    auto variance = [&](const std::vector<double>& v, std::size_t seq) {
+        double mean = 0, sq = 0;
+        for (int r = 0; r < R; ++r) mean += v[seq * R + r];
+        mean /= R;
+        for (int r = 0; r < R; ++r) sq += (v[seq * R + r] - mean) * (v[seq * R + r] - mean);
+        return sq / (R - 1);
+    };
+
+    StratifyCheck check;
+    check.sequences = static_cast<int>(seqs.size());
+    check.length = static_cast<int>(bestSeqIdx.size());
+    check.replicates = R;
+
+    double logGain = 0;
+    int counted = 0;
+    for (std::size_t i = 0; i < seqs.size(); ++i) {
+        const double independent = variance(scores[0], i), stratified = variance(scores[1], i);
+        if (!(independent > 0) || !(stratified > 0)) continue; // deterministic sequence, no noise to reduce
+        logGain += std::log(independent / stratified);
+        ++counted;
+        if (i == 0) check.bestGain = independent / stratified;
+    }
+    check.gain = counted > 0 ? std::exp(logGain / counted) : 1;
+    return check;
+}
@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+int ThreadPool::resolve_threads(int threads) {
+    if (threads > 0) return threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(int threads) {
+    const int n = resolve_threads(threads);
+    workers.reserve(n - 1);
+    for (int i = 0; i < n - 1; ++i) {
+        workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+void ThreadPool::worker_loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return; // stopping and drained
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+void ThreadPool::parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn) {
+    if (n == 0) return;
+
+    // Shared with helper tasks, which may start after the loop is already finished
+    struct Loop {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::size_t n = 0;
+        const std::function<void(std::size_t)>* fn = nullptr;
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+    auto loop = std::make_shared<Loop>();
+    loop->n = n;
+    loop->fn = &fn;
+
+    // fn stays valid: the caller only returns once every index has completed,
+    // and late helpers stop at the bounds check before touching it
+    auto drain = [](Loop& l) {
+        std::size_t finished = 0;
+        for (std::size_t i; (i = l.next.fetch_add(1)) < l.n; ++finished) {
+            (*l.fn)(i);
+        }
+        if (finished > 0 && l.done.fetch_add(finished) + finished == l.n) {
+            std::lock_guard<std::mutex> lock(l.mtx);
+            l.cv.notify_all();
+        }
+    };
+
+    const std::size_t helpers = std::min(n - 1, workers.size());
+    for (std::size_t h = 0; h < helpers; ++h) {
+        submit([loop, drain] { drain(*loop); });
+    }
+
+    drain(*loop);
+
+    std::unique_lock<std::mutex> lock(loop->mtx);
+    loop->cv.wait(lock, [&] { return loop->done.load() == n; });
+}
@@ -1,4 +1,10 @@
 #include "UI.h"
+#include "Exploit.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <iomanip> // std::setw
+#include <sstream>
 
 void print_logo() {
     std::cout <<
@@ -20,9 +26,60 @@ void print_experiment_overview(const ExperimentRunner::ExperimentConfig& cfg, in
     std::cout << "\n";
     std::cout << "ShuffleLab — Randomness Analysis\n";
     std::cout << "--------------------------------\n";
-    std::cout << "Evaluating " << numSequences << " sequences\n";
-    std::cout << "Shuffles per sequence : " << cfg.kMax << "\n";
-    std::cout << "Trials                : " << cfg.trials << "\n";
+    if (!cfg.exploitSequence.empty()) {
+        std::cout << "Sequence              : ";
+        for (std::size_t i = 0; i < cfg.exploitSequence.size(); ++i) {
+            std::cout << (i > 0 ? " \u2192 " : "") << to_string(cfg.exploitSequence[i]);
+        }
+        std::cout << "\nTrials                : " << cfg.exploitTrials << " per estimate, sorted deck\n";
+        std::cout << "Seed                  : " << cfg.seed << "\n";
+        std::cout << "Tracking              : " << cfg.track.size() << " event" << (cfg.track.size() == 1 ? "" : "s");
+        return;
+    }
+    if (cfg.timeBudget > 0) {
+        std::cout << "Time budget           : " << cfg.timeBudget << " s (";
+        for (int s = static_cast<int>(Shuffle::Cut); s <= static_cast<int>(Shuffle::Overhand); ++s) {
+            std::cout << (s > static_cast<int>(Shuffle::Cut) ? ", " : "") << to_string(static_cast<Shuffle>(s))
+                      << " " << cfg.timeCost[s] << " s";
+        }
+        std::cout << ")\n";
+        std::cout << "Search                : branch-and-bound, up to " << ExperimentRunner::SEARCH_K_MAX << " shuffles\n";
+    } else if (cfg.beamWidth > 0) {
+        std::cout << "Search                : beam of " << cfg.beamWidth << ", lengths 1 to " << cfg.beamLength << "\n";
+    } else {
+        std::cout << "Evaluating " << numSequences << " sequences\n";
+    }
+    if (cfg.shardCount > 1) {
+        const auto [begin, end] = ExperimentRunner::shard_range(cfg, numShufflesAllowed);
+        std::cout << "Shard                 : " << cfg.shardIndex << "/" << cfg.shardCount
+                  << " (sequences " << begin << " to " << end << ")\n";
+    }
+    if (cfg.timeBudget == 0 && cfg.beamWidth == 0) std::cout << "Shuffles per sequence : " << cfg.kMax << "\n";
+    if (cfg.streamHands > 0) {
+        std::cout << "Game cycle            : " << cfg.streamHands << " hands after " << cfg.streamWarmup
+                  << " warm-up, collect " << to_string(cfg.collect) << ", " << cfg.pokerSeats << " seats\n";
+    } else {
+        std::cout << "Trials                : " << cfg.trials << "\n";
+    }
+    std::cout << "Seed                  : " << cfg.seed << "\n";
+    if (cfg.sharePrefixes) {
+        const int depth = std::min(cfg.kMax, ExperimentRunner::PREFIX_GROUP_DEPTH);
+        std::cout << "Trials                : shared prefixes, " << ExperimentRunner::num_sequences(depth, numShufflesAllowed)
+                  << " sequences per task\n";
+    }
+    if (cfg.stratify) {
+        std::cout << "Trials                : Latin-hypercube stratified leading draws\n";
+    }
+    if (cfg.exactBudget > 0) {
+        std::cout << "Trials                : start from exact prefix distributions of up to " << cfg.exactBudget << " decks\n";
+    }
+    if (cfg.poolSize > 0) {
+        std::cout << "Shuffles              : drawn from pools of " << cfg.poolSize << " permutations each\n";
+    }
+    if (cfg.pipelineShuffleWorkers > 0) {
+        std::cout << "Pipeline              : " << cfg.pipelineShuffleWorkers << " shuffle -> "
+                  << cfg.pipelineStatsWorkers << " stats workers\n";
+    }
     std::cout << "Tests                 : ";
 
     bool first = true;
@@ -38,11 +95,22 @@ void print_experiment_overview(const ExperimentRunner::ExperimentConfig& cfg, in
         std::cout << (first ? "" : ", ") << "Mixing";
         first = false;
     }
+    if (cfg.testPoker) {
+        std::cout << (first ? "" : ", ") << "Hold'em (" << cfg.pokerSeats << " seats)";
+        first = false;
+    }
 
     if (first) {
         std::cout << "None";
     }
 
+    const ExperimentRunner::ScoreWeights defaults;
+    const auto& w = cfg.weights;
+    if (w.uniformity != defaults.uniformity || w.adjacency != defaults.adjacency ||
+        w.displacement != defaults.displacement || w.poker != defaults.poker) {
+        std::cout << "\nWeights               : " << weights_to_string(w);
+    }
+
 }
 
 void print_experiment_results(const ExperimentRunner::ExperimentConfig& cfg, const DeckContext& ctx, const std::vector<int>& bestShuffleSeqIdx, int numShufflesAllowed) {
@@ -65,6 +133,7 @@ void print_experiment_results(const ExperimentRunner::ExperimentConfig& cfg, con
     print_report(report_uniformity(ctx));
     print_report(report_adjacency(ctx));
     print_report(report_displacement(ctx));
+    if (cfg.testPoker) print_report(report_poker(ctx, cfg.pokerSeats));
 
     std::cout << "Example Before and After of Shuffle Sequence on Sorted Deck:\n\n";
     DeckContext example;
@@ -79,6 +148,308 @@ void print_experiment_results(const ExperimentRunner::ExperimentConfig& cfg, con
 
 
 
+// Search effort and time used by a --budget run
+void print_search_summary(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::SearchOutcome& outcome) {
+    std::cout << "\n\nSearch: " << outcome.evaluated << " of " << outcome.feasible
+              << " sequences within budget simulated (" << outcome.pruned << " subtrees pruned)";
+    if (!outcome.complete) {
+        std::cout << "\nIncomplete: stopped at the " << ExperimentRunner::SEARCH_EVALUATIONS_MAX
+                  << "-sequence limit - the best found so far, not proven best";
+    }
+    if (outcome.bestSeqIdx.empty()) {
+        std::cout << "\nNo shuffle fits in " << cfg.timeBudget << " s\n";
+        return;
+    }
+    std::cout << "\nTime used: " << outcome.bestTime << " s of " << cfg.timeBudget << " s, score " << outcome.bestScore;
+}
+
+// Best sequences by point score, with their bootstrap intervals and chance of ranking first
+void print_bootstrap(const ExperimentRunner::ExperimentConfig& cfg, std::vector<ExperimentRunner::BootstrapResult> results, int numShufflesAllowed, std::size_t count) {
+    std::size_t contenders = 0;
+    for (const auto& r : results) contenders += (r.pFirst > 0);
+
+    std::stable_sort(results.begin(), results.end(), [](const auto& a, const auto& b) { return a.score < b.score; });
+
+    std::cout << "\n\nBootstrap (" << cfg.bootstrap << " replicates, 95% intervals): "
+              << contenders << " of " << results.size() << " sequences rank first at least once\n";
+
+    for (std::size_t i = 0; i < results.size() && i < count; ++i) {
+        const auto& r = results[i];
+        auto seq = shuffleIdx_to_string(ExperimentRunner::sequence_from_rank(r.rank, cfg.kMax, numShufflesAllowed));
+
+        std::cout << "  " << std::setw(2) << (i + 1) << ". score " << r.score << " [" << r.low << ", " << r.high
+                  << "]  P(first) " << r.pFirst << "  ";
+        for (std::size_t j = 0; j < seq.size(); ++j) {
+            if (j > 0)
+                std::cout << " \u2192 ";
+            std::cout << seq[j];
+        }
+        std::cout << "\n";
+    }
+}
+
+// Pooled scores against direct simulation, next to the noise between two direct runs
+// (differences in log(1 + score), so roughly relative)
+void print_pool_check(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::PoolCheck& check) {
+    auto percent = [](double logDiff) { return 100 * (std::exp(logDiff) - 1); };
+
+    std::cout << "\n\nPermutation pool check (" << check.sequences << " sequences of length " << check.length
+              << ", simulated pooled and direct; differences relative to 1 + score):\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  pooled vs direct      : " << percent(check.pooledRms) << "% RMS, bias " << std::showpos
+              << percent(check.bias) << "%" << std::noshowpos << "\n";
+    std::cout << "  direct vs direct      : " << percent(check.noiseRms) << "% RMS (another seed - Monte Carlo noise at "
+              << (cfg.streamHands > 0 ? cfg.streamHands : cfg.trials) << (cfg.streamHands > 0 ? " hands" : " trials") << ")\n";
+    std::cout << "  pool error            : ";
+    if (check.poolError > 0) std::cout << "~" << percent(check.poolError) << "% beyond the noise\n";
+    else                     std::cout << "within the noise\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "  best sequence         : " << check.bestPooled << " pooled, " << check.bestDirect << " direct\n";
+}
+
+// Variance of stratified against independent trials, as effective trials
+void print_stratify_check(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::StratifyCheck& check) {
+    std::cout << "\n\nStratified trials (" << check.sequences << " sequences of length " << check.length << ", "
+              << check.replicates << " seeds each, score variance independent / stratified):\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  ESS gain              : x" << check.gain << " - " << cfg.trials << " stratified trials ~ "
+              << std::setprecision(0) << check.gain * cfg.trials << " independent (geometric mean)\n";
+    std::cout << std::setprecision(2);
+    std::cout << "  best sequence         : x" << check.bestGain << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// Sequence prefixes whose distribution was enumerated exactly, with the decks each held
+void print_exact_prefixes(const ExperimentRunner::ExperimentConfig& cfg, const std::vector<ExactPrefixes::Tracked>& tracked) {
+    std::cout << "\n\nExact prefixes (support at most " << cfg.exactBudget << " decks):\n";
+    if (tracked.empty()) {
+        std::cout << "  none - every sequence starts with a riffle or hindu, or its first shuffle exceeds the budget\n";
+        return;
+    }
+    for (const auto& t : tracked) {
+        std::string prefix;
+        for (Shuffle s : t.prefix) {
+            if (!prefix.empty()) prefix += ",";
+            prefix += to_string(s);
+        }
+        std::cout << "  " << std::left << std::setw(30) << prefix << std::right << " : " << t.support << " decks\n";
+    }
+}
+
+// Importance-sampled event probabilities next to plain Monte Carlo over as many trials
+void print_exploit(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::ExploitOutcome& outcome) {
+    std::cout << "\n\nCard tracking (importance sampling, 95% intervals; " << outcome.pilotTrials
+              << " trials fitting proposals):\n";
+
+    for (std::size_t e = 0; e < outcome.events.size(); ++e) {
+        const auto& r = outcome.events[e];
+        std::cout << "  " << std::setw(2) << (e + 1) << ". " << track_to_string(cfg.track[e]) << "\n";
+        if (r.hits == 0) {
+            std::cout << "      not reached in " << outcome.trials << " trials after " << r.rounds << " refinements\n";
+        } else {
+            std::cout << "      P " << r.probability << " [" << r.low << ", " << r.high << "]  " << r.hits << " hits, ESS "
+                      << std::fixed << std::setprecision(0) << r.ess << std::defaultfloat << std::setprecision(6);
+            if (r.tilted)           std::cout << ", " << r.rounds << " refinement" << (r.rounds == 1 ? "" : "s") << "\n";
+            else if (r.rejected)    std::cout << ", untilted (the fitted proposal did no better than plain Monte Carlo)\n";
+            else if (r.rounds == 1) std::cout << ", untilted (not rare)\n";
+            else                    std::cout << ", untilted (no proposal reached the event in " << r.rounds << " rounds)\n";
+        }
+        std::cout << "      plain Monte Carlo: " << r.directHits << " of " << outcome.trials << " (" << r.directProbability << ")";
+        if (r.plainTrials > 0) {
+            std::cout << ", needs ~" << std::fixed << std::setprecision(0) << r.plainTrials << std::defaultfloat
+                      << std::setprecision(6) << " trials for this interval";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Best sequence the beam found at each length
+void print_beam_summary(const ExperimentRunner::BeamOutcome& outcome) {
+    std::cout << "\n\nBeam search: " << outcome.evaluated << " sequences simulated\n";
+    std::cout << "Best sequence per length:\n";
+
+    for (std::size_t len = 1; len <= outcome.levels.size(); ++len) {
+        const auto& level = outcome.levels[len - 1];
+        auto seq = shuffleIdx_to_string(level.seqIdx);
+
+        std::cout << "  " << std::setw(2) << len << ". score " << level.score << "  ";
+        for (std::size_t j = 0; j < seq.size(); ++j) {
+            if (j > 0)
+                std::cout << " \u2192 ";
+            std::cout << seq[j];
+        }
+        std::cout << "\n";
+    }
+}
+
+// Fitted create_cdf parameters next to the current defaults
+void print_calibration(const CalibrationData& data, const CalibrationOutcome& outcome, std::size_t files) {
+    std::cout << "\n";
+    std::cout << "ShuffleLab — Model Calibration\n";
+    std::cout << "--------------------------------\n";
+    std::cout << "Records               : " << data.records << " from " << files << " file" << (files == 1 ? "" : "s");
+    if (outcome.rejected > 0) std::cout << " (" << outcome.rejected << " deck records rejected)";
+    std::cout << "\n";
+    std::cout << "Simulation            : " << outcome.candidates << " candidates over "
+              << outcome.tablesBuilt << " cached tables\n\n";
+
+    auto params = [](const CdfParams& p) {
+        std::ostringstream ss;
+        ss << "{" << p.min << ", " << p.max << ", " << p.centre << ", " << std::setprecision(3) << p.spread << "}";
+        return ss.str();
+    };
+
+    std::cout << "  " << std::left << std::setw(15) << "Table" << std::setw(12) << "Method" << std::setw(9) << "Records"
+              << std::setw(22) << "Fitted" << std::setw(22) << "Default" << "Fit\n";
+    for (const TableFit& fit : outcome.fits) {
+        std::cout << "  " << std::setw(15) << to_string(fit.table);
+        switch (fit.method) {
+            case TableFit::Method::Default:
+                std::cout << std::setw(12) << "no data" << std::setw(9) << 0 << std::setw(22) << "-"
+                          << std::setw(22) << params(fit.params) << "\n";
+                continue;
+            case TableFit::Method::Likelihood: std::cout << std::setw(12) << "likelihood"; break;
+            case TableFit::Method::Simulation: std::cout << std::setw(12) << "simulation"; break;
+        }
+        std::cout << std::setw(9) << fit.records << std::setw(22) << params(fit.params)
+                  << std::setw(22) << params(default_params(fit.table))
+                  << (fit.method == TableFit::Method::Likelihood ? "log L / record " : "χ² ") << fit.objective << "\n";
+    }
+    std::cout << std::right;
+
+    std::cout << "\nCopy fitted rows into DEFAULT_PARAMS (Shuffle.cpp) to use them.\n";
+}
+
+// One line per manifest experiment, then how much work the shared cache saved
+void print_manifest(const Manifest& manifest, const ManifestOutcome& outcome) {
+    std::cout << "\n";
+    std::cout << "ShuffleLab — Experiment Manifest\n";
+    std::cout << "--------------------------------\n";
+    std::cout << "Experiments           : " << manifest.experiments.size() << "\n";
+    std::cout << "Seed                  : " << manifest.seed << " (experiments without their own)\n";
+    std::cout << "Threads               : " << ThreadPool::resolve_threads(manifest.threads) << "\n\n";
+
+    std::cout << "  " << std::left << std::setw(16) << "Experiment" << std::right << std::setw(4) << "k"
+              << std::setw(8) << "trials" << std::setw(11) << "sequences" << std::setw(9) << "reused"
+              << std::setw(10) << "seconds" << std::setw(12) << "score" << "  best\n";
+
+    uint64_t sequences = 0, reused = 0;
+    for (std::size_t i = 0; i < outcome.experiments.size(); ++i) {
+        const auto& e = outcome.experiments[i];
+        const auto& cfg = manifest.experiments[i].cfg;
+        sequences += e.sequences;
+        reused += e.reused;
+
+        std::cout << "  " << std::left << std::setw(16) << e.name << std::right << std::setw(4) << cfg.kMax
+                  << std::setw(8) << (cfg.streamHands > 0 ? cfg.streamHands : cfg.trials) << std::setw(11) << e.sequences
+                  << std::setw(9) << e.reused << std::setw(10) << std::fixed << std::setprecision(2) << e.seconds
+                  << std::defaultfloat << std::setprecision(6) << std::setw(12) << e.bestScore << "  ";
+        for (std::size_t j = 0; j < e.best.size(); ++j) {
+            if (j > 0)
+                std::cout << " \u2192 ";
+            std::cout << to_string(e.best[j]);
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "\n" << reused << " of " << sequences << " sequence evaluations reused, "
+              << outcome.cacheEntries << " results cached";
+    if (!manifest.cachePath.empty()) std::cout << " in " << manifest.cachePath;
+    std::cout << " (" << std::fixed << std::setprecision(2) << outcome.seconds << " s)\n" << std::defaultfloat;
+}
+
+// Per-test and score top lists, the Pareto front and its best under each --weights set
+void print_rankings(const ExperimentRunner::ExperimentConfig& cfg, const ExperimentRunner::Rankings& rankings, int numShufflesAllowed) {
+    auto print_seq = [&](uint64_t rank) {
+        auto seq = shuffleIdx_to_string(ExperimentRunner::sequence_from_rank(rank, cfg.kMax, numShufflesAllowed));
+        for (std::size_t j = 0; j < seq.size(); ++j) {
+            if (j > 0)
+                std::cout << " \u2192 ";
+            std::cout << seq[j];
+        }
+        std::cout << "\n";
+    };
+
+    if (cfg.top > 0) {
+        static constexpr const char* NAMES[ExperimentRunner::OBJECTIVES] = {
+            "uniformity χ² (target 51)", "adjacency χ² (target 50)", "mean displacement (target 17.33)", "Hold'em χ²/df (target 1)"};
+        const double ExperimentRunner::SequenceResult::*fields[ExperimentRunner::OBJECTIVES] = {
+            &ExperimentRunner::SequenceResult::uniformity, &ExperimentRunner::SequenceResult::adjacency,
+            &ExperimentRunner::SequenceResult::displacement, &ExperimentRunner::SequenceResult::poker};
+
+        for (int o = 0; o < ExperimentRunner::OBJECTIVES; ++o) {
+            const auto& list = rankings.byObjective[o];
+            if (list.empty()) continue;
+            std::cout << "\n\nClosest by " << NAMES[o] << ":\n";
+            for (std::size_t i = 0; i < list.size(); ++i) {
+                std::cout << "  " << std::setw(2) << (i + 1) << ". " << list[i].*fields[o] << "  ";
+                print_seq(list[i].rank);
+            }
+        }
+
+        std::cout << "\n\nBest by score:\n";
+        for (std::size_t i = 0; i < rankings.byScore.size(); ++i) {
+            std::cout << "  " << std::setw(2) << (i + 1) << ". score " << rankings.byScore[i].score << "  ";
+            print_seq(rankings.byScore[i].rank);
+        }
+    }
+
+    // Front by score, statistics of every enabled test alongside
+    auto front = rankings.front;
+    std::stable_sort(front.begin(), front.end(), [](const auto& a, const auto& b) { return a.score < b.score; });
+    const std::size_t shown = cfg.top > 0 ? static_cast<std::size_t>(cfg.top) : 10;
+
+    std::cout << "\n\nPareto front: " << front.size()
+              << " sequences no other beats on every test (best " << std::min(shown, front.size()) << " by score)\n";
+    for (std::size_t i = 0; i < front.size() && i < shown; ++i) {
+        const auto& r = front[i];
+        std::cout << "  " << std::setw(2) << (i + 1) << ". score " << r.score;
+        if (r.uniformity != -1)   std::cout << "  U " << r.uniformity;
+        if (r.adjacency != -1)    std::cout << "  A " << r.adjacency;
+        if (r.displacement != -1) std::cout << "  D " << r.displacement;
+        if (r.poker != -1)        std::cout << "  P " << r.poker;
+        std::cout << "  ";
+        print_seq(r.rank);
+    }
+
+    if (!rankings.reweighted.empty()) {
+        std::cout << "\nBest under other weights (from the front, no new trials):\n";
+        for (std::size_t i = 0; i < rankings.reweighted.size() && i < cfg.reweights.size(); ++i) {
+            std::cout << "  " << weights_to_string(cfg.reweights[i]) << "\n      ";
+            if (front.empty()) {
+                std::cout << "no sequences\n";
+                continue;
+            }
+            std::cout << "score " << rankings.reweighted[i].score << "  ";
+            print_seq(rankings.reweighted[i].rank);
+        }
+    }
+}
+
+std::string weights_to_string(const ExperimentRunner::ScoreWeights& w) {
+    std::ostringstream ss;
+    ss << "uniformity " << w.uniformity << ", adjacency " << w.adjacency << ", mixing " << w.displacement
+       << ", poker " << w.poker;
+    return ss.str();
+}
+
+// Top entries of a score-ordered result list
+void print_ranking(const std::vector<ExperimentRunner::SequenceResult>& ranked, int k, int numShufflesAllowed, std::size_t count) {
+    std::cout << "\n\nTop " << std::min(count, ranked.size()) << " of " << ranked.size() << " sequences:\n";
+
+    for (std::size_t i = 0; i < ranked.size() && i < count; ++i) {
+        auto seq = shuffleIdx_to_string(ExperimentRunner::sequence_from_rank(ranked[i].rank, k, numShufflesAllowed));
+
+        std::cout << "  " << (i + 1) << ". score " << ranked[i].score << "  ";
+        for (std::size_t j = 0; j < seq.size(); ++j) {
+            if (j > 0)
+                std::cout << " \u2192 ";
+            std::cout << seq[j];
+        }
+        std::cout << "\n";
+    }
+}
+
 void print_help() {
     std::cout <<
 R"(
@@ -92,15 +463,145 @@ MODES (choose one):
   --run        Run a shuffle experiment
   --help       Show this help message
   --desc       Describe ShuffleLab and its goals
+  --merge <files...>  Combine shard result files into the global ranking
+  --calibrate <files...>  Fit the shuffle models' create_cdf parameters to
+                   recorded shuffles (see CALIBRATION)
+  --manifest <file>  Run every experiment in a JSON manifest in one process
+                   (see MANIFESTS)
+  --serve <socket>  Stay running and answer JSON queries on a Unix socket, with
+                   the pool and result cache kept warm (see DAEMON)
 
 RUN OPTIONS:
   --k <int>        Maximum shuffle sequence length
   --trials <int>   Trials per shuffle sequence
-
-TEST SELECTION:
+  --seed <int>     Master RNG seed (random if omitted, printed in overview)
+  --threads <int>  Worker threads (default 0 = all cores; results do not
+                   depend on the thread count)
+  --share-prefixes  Continue each sequence's trials from its prefix's decks, so
+                   shared prefixes are simulated once (different draws from the
+                   default, comparable between sequences; not with --shard,
+                   --out, --checkpoint, --stream, --pipeline or --bootstrap)
+  --stratify       Latin-hypercube sample each shuffle's leading draw (cut
+                   point, riffle split, hindu pickups, overhand packet) across
+                   a sequence's trials; prints the effective-sample-size gain
+  --exact <int>    Enumerate the deck distribution after each sequence's leading
+                   cuts and overhands exactly while it holds at most this many
+                   decks, and start the trials from it (riffles and hindus
+                   always end the exact part)
+  --pool <int>     Draw every shuffle from this many pre-sampled permutations
+                   of it, applied as one gather (approximate, ~4-8x faster
+                   shuffles); a check against direct simulation is printed
+  --pool-file <file>  Keep the pools in file and memory-map them on later
+                   runs (rebuilt if the size or model parameters differ)
+  --pipeline <S>:<T>  Pipelined mode: S shuffle workers stream decks through
+                   lock-free rings to T stats workers (same results)
+
+SHARDING:
+  --shard <i>/<N>  Evaluate only slice i (0-based) of N of the sequence space
+  --out <file>     Write every sequence's result to file (required with --shard)
+
+  --bootstrap <int>  Resample each sequence's trials this many times and report
+                   95% score intervals and the chance each sequence ranks first
+
+RANKINGS (with --run, or with --merge to rerank result files without trials):
+  --top <int>      Also list the sequences closest to target on each test, the
+                   best by score and the Pareto front (sequences no other beats
+                   on every test at once)
+  --weights <list> Score weights, e.g. uniformity=1,adjacency=1,mixing=0.2
+                   (defaults uniformity=0.25,adjacency=0.7,mixing=0.05,poker=0.5).
+                   Repeat (up to 16 more) to score the front under other weights
+
+CHECKPOINTING:
+  --checkpoint <file>       Periodically save sweep progress to file
+  --checkpoint-every <int>  Seconds between checkpoints (default 60)
+  --resume <file>           Continue a stopped sweep (restores k, trials,
+                            tests, seed, shard, rankings and --out file; keeps
+                            checkpointing)
+
+TEST SELECTION (all enabled unless one or more are named):
   --uniformity     Enable position uniformity test (chi-squared)
   --adjacency      Enable card adjacency test (chi-squared)
   --mixing         Enable displacement / mixing test
+  --poker          Enable Hold'em deal test (per-seat hand classes and equity;
+                   not in the default set)
+  --seats <int>    Seats dealt by --poker / --stream, 2-10 (default 6)
+
+GAME CYCLE (steady-state bias of a deck that is never re-sorted):
+  --stream <int>   Play this many consecutive hands per sequence: deal, collect,
+                   reshuffle with the sequence (replaces --trials)
+  --warmup <int>   Hands played before statistics start (default 100)
+  --collect <m>    How the deck is gathered between hands:
+                     piles  - stub, folded hands, burns and board as clumps (default)
+                     keep   - cards stay in dealt order
+                     sorted - fresh sorted deck (same as independent trials)
+
+TIME BUDGET (best sequence of any length, up to 20 shuffles, that fits in time):
+  --budget <sec>   Branch-and-bound search instead of the n^k sweep (--k unused).
+                   Subtrees are skipped when a lower bound on their score, from
+                   the original neighbours left together, cannot beat the best
+                   found (needs the adjacency test to prune). Budgets run up to
+                   60 s; a search stops, reported incomplete, after 20000
+                   simulated sequences
+  --time-costs <list>  Seconds per shuffle, e.g. cut=2,riffle=4,hindu=6,overhand=4
+                   (defaults shown; hindu and overhand are per pass, 0.01 s steps)
+
+BEAM SEARCH (sequences longer than --k allows):
+  --beam <int>     Keep this many best prefixes at each length and extend each
+                   by every shuffle; prints the best sequence of each length
+  --length <int>   Longest sequence, 1-20 (default 20)
+
+CARD TRACKING (chance of a specific leak after one fixed sequence):
+  --exploit <list> Sequence to track cards through, e.g. riffle,riffle,cut
+                   (replaces the sweep; --k, --trials and test toggles unused)
+  --track <event>  Event to estimate, repeatable (up to 16):
+                     pos:<card>:<lo>-<hi>   card ends in positions lo-hi (0 = top)
+                     seat:<card>:<seat>     card is a hole card of seat (from 1)
+                     pair:<card>:<card>[:<d>]  cards within d positions (default 1)
+                   cards as 0-51 or rank and suit, e.g. As, Td, 7c
+  --exploit-trials <int>  Trials per estimate (default 20000)
+  Rare events are importance sampled: the cut points, pickup counts and the
+  position each riffle lands the card at are drawn from proposals fitted to
+  the event, and hits reweighted back to the model; each estimate is printed
+  with its 95% interval next to plain Monte Carlo and the trials plain Monte
+  Carlo would need for the same interval. A proposal that does no better
+  than plain Monte Carlo is dropped and the plain estimate reported.
+
+CALIBRATION (text files, one record per line, '#' comments):
+  <table> <n>      An observed packet size: cut, riffle (split), hindu_ops,
+                   hindu_cut, hindu_drop, overhand_cut or overhand_drop
+  <shuffle> <52 cards> | <52 cards>
+                   Deck before and after one cut, riffle, hindu or overhand
+                   (cards 0-51, top first)
+  Packet sizes, cuts and riffles are fitted by maximum likelihood; hindu and
+  overhand deck orders by simulating candidate parameters in parallel.
+
+MANIFESTS (JSON; sweeps share one thread pool and one result cache):
+  {"seed": 7, "threads": 0, "cache": "nightly.slc",
+   "defaults": {"trials": 100},
+   "experiments": [{"name": "riffles", "k": 6, "shuffles": ["cut", "riffle"]},
+                   {"k": 5, "tests": ["adjacency"], "weights": {"adjacency": 1}}]}
+  Experiment keys: name, k, trials, seed, tests, seats, stream, warmup,
+  collect, shuffles, weights, share_prefixes. A sequence an earlier
+  experiment evaluated with the same trials, seed, tests and game-cycle
+  settings is not simulated again.
+
+DAEMON (--serve; takes only --threads and --cache, one JSON request per line):
+  {"op": "score", "sequences": [["riffle", "riffle", "cut"]], "trials": 100}
+  {"op": "best", "k": 5, "shuffles": ["cut", "riffle"], "top": 3}
+  {"op": "status"}  {"op": "ping"}  {"op": "shutdown"}
+  score and best take the manifest experiment keys (seed defaults to 0) and
+  answer {"ok": true, "results": [...], ...} or {"ok": false, "error": ...}.
+  Connections are served concurrently on one pool; results any request
+  simulated are reused by later ones and written to --cache on exit.
+
+CACHING:
+  --cache <file>   Reuse/store per-sequence results across runs (keyed by
+                   model parameters, sequence, trials, seed and tests)
+
+PROFILING:
+  --profile        Time each shuffle model, observe_* and report_* stage and
+                   print a breakdown (adds cycles, IPC, branch and L1 misses
+                   when hardware counters are available)
 
 DEFAULT BEHAVIOUR:
   Running with --run and no additional options uses a recommended
@@ -110,6 +611,19 @@ EXAMPLES:
   shufflelab
   shufflelab --run
   shufflelab --run --k 6 --trials 20000
+  shufflelab --run --k 8 --checkpoint sweep.ckpt
+  shufflelab --run --resume sweep.ckpt
+  shufflelab --run --k 8 --seed 1 --shard 0/2 --out s0.slr
+  shufflelab --merge s0.slr s1.slr
+  shufflelab --merge s0.slr s1.slr --weights adjacency=1,uniformity=1 --top 5
+  shufflelab --calibrate riffles.txt overhands.txt
+  shufflelab --manifest nightly.json
+  shufflelab --serve /tmp/shufflelab.sock --cache lab.slc
+  shufflelab --run --budget 30 --time-costs riffle=5
+  shufflelab --run --exploit riffle,riffle,cut --track seat:As:1 --track pos:Ac:51
+  shufflelab --run --beam 32 --length 16
+  shufflelab --run --k 7 --pool 100000 --pool-file pools.slp
+  shufflelab --run --k 5 --exact 1000000
   shufflelab --desc
 
 )";